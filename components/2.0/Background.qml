@@ -23,18 +23,38 @@
 ***************************************************************************/
 
 import QtQuick 2.0
+import QtQuick.Window 2.2
 
 FocusScope {
     id: container
 
-    property alias source: image.source
+    property url source
     property alias fillMode: image.fillMode
     property alias status: image.status
 
+    // the greeter serves local pictures scaled to the screen and caches
+    // them, anything else is loaded as it is
+    function scaledSource() {
+        if (typeof __sddm_backgrounds === "undefined" || !__sddm_backgrounds)
+            return source
+        var url = source.toString()
+        if (url.indexOf("file:") !== 0 && url.indexOf("qrc:") !== 0)
+            return source
+        var mode = fillMode == Image.PreserveAspectCrop ? "crop" : fillMode == Image.Stretch ? "stretch" : ""
+        if (mode === "")
+            return source
+        // wait for the size instead of decoding it all
+        if (width <= 0 || height <= 0)
+            return ""
+        // decoded for the pixels of the screen, not its logical size
+        return "image://sddm-background/" + mode + "/" + Math.round(width) + "x" + Math.round(height) +
+                "@" + Screen.devicePixelRatio + "/" + encodeURIComponent(url)
+    }
 
     Image {
         id: image
         anchors.fill: parent
+        source: container.scaledSource()
 
         clip: true
         focus: true
@@ -32,11 +32,27 @@ Column {
     property alias timeFont: time.font
     property alias dateFont: date.font
 
+    // the clock only shows minutes, so wake up once when the next one
+    // starts instead of polling
+    function update() {
+        container.dateTime = new Date()
+        timer.interval = 60000 - container.dateTime.getSeconds() * 1000 - container.dateTime.getMilliseconds()
+        timer.restart()
+    }
+
     Timer {
-        interval: 100; running: true; repeat: true;
-        onTriggered: container.dateTime = new Date()
+        id: timer
+        onTriggered: container.update()
     }
 
+    // the time may have jumped while nobody looked, e.g. after a suspend
+    Connections {
+        target: typeof idleMonitor !== "undefined" ? idleMonitor : null
+        onIdleChanged: if (!idleMonitor.idle) container.update()
+    }
+
+    Component.onCompleted: container.update()
+
     Text {
         id: time
         anchors.horizontalCenter: parent.horizontalCenter
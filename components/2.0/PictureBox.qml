@@ -83,6 +83,8 @@ FocusScope {
             clip: true
             smooth: true
             fillMode: Image.PreserveAspectCrop
+            sourceSize.width: width
+            sourceSize.height: height
         }
 
         Text {
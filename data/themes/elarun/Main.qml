@@ -204,12 +204,15 @@ Rectangle {
 
                     Timer {
                         id: time
-                        interval: 100
+                        interval: 0
                         running: true
-                        repeat: true
 
+                        // fire again when the next minute starts
                         onTriggered: {
-                            dateTime.text = Qt.formatDateTime(new Date(), "dddd, dd MMMM yyyy HH:mm AP")
+                            var now = new Date()
+                            dateTime.text = Qt.formatDateTime(now, "dddd, dd MMMM yyyy HH:mm AP")
+                            interval = 60000 - now.getSeconds() * 1000 - now.getMilliseconds()
+                            restart()
                         }
                     }
 
@@ -25,11 +25,15 @@ Item {
   implicitHeight  : sp_clock_text.implicitHeight
 
 
+  // Fire again when the next minute starts
   Timer {
-    interval    : 100
+    interval    : 0
     running     : true
-    repeat      : true;
-    onTriggered : sp_clock.value = new Date()
+    onTriggered : {
+      sp_clock.value = new Date()
+      interval = 60000 - sp_clock.value.getSeconds() * 1000 - sp_clock.value.getMilliseconds()
+      restart()
+    }
   }
 
   Text {
@@ -0,0 +1,106 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "ConfigNotifier.h"
+
+#include "ConfigReader.h"
+
+#include <QDebug>
+#include <QSocketNotifier>
+#include <QTimer>
+
+namespace SDDM {
+    // editors and package managers write several times in a row
+    static const int s_reloadDelay = 500;
+
+    ConfigNotifier::ConfigNotifier(ConfigBase *config, QObject *parent) : QObject(parent), m_config(config) {
+        for (const ConfigSection *section : m_config->sections()) {
+            for (const ConfigEntryBase *entry : section->entries())
+                m_values.insert(qMakePair(section->name(), entry->name()), entry->value());
+        }
+
+        m_reloadTimer = new QTimer(this);
+        m_reloadTimer->setSingleShot(true);
+        m_reloadTimer->setInterval(s_reloadDelay);
+        connect(m_reloadTimer, &QTimer::timeout, this, &ConfigNotifier::reload);
+
+        const int fd = m_config->changeDescriptor();
+        if (fd == -1) {
+            qWarning() << "Configuration changes won't be noticed until the next reload";
+            return;
+        }
+
+        m_notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        connect(m_notifier, &QSocketNotifier::activated, this, &ConfigNotifier::activated);
+    }
+
+    void ConfigNotifier::load() {
+        // the notification may not have been dispatched yet, only look
+        // at the descriptor, reading it is up to the configuration
+        if (!m_reloadTimer->isActive() && !m_config->changesPending())
+            return;
+
+        m_reloadTimer->stop();
+        emit aboutToReload();
+        if (m_config->load())
+            compare();
+
+        if (m_notifier)
+            m_notifier->setEnabled(true);
+    }
+
+    void ConfigNotifier::reload() {
+        m_reloadTimer->stop();
+
+        qDebug() << "Reloading the configuration";
+        emit aboutToReload();
+        m_config->reload();
+        compare();
+
+        if (m_notifier)
+            m_notifier->setEnabled(true);
+    }
+
+    void ConfigNotifier::activated() {
+        // the descriptor stays readable until the configuration drains it
+        m_notifier->setEnabled(false);
+        m_reloadTimer->start();
+    }
+
+    void ConfigNotifier::compare() {
+        bool changed = false;
+
+        for (const ConfigSection *section : m_config->sections()) {
+            for (const ConfigEntryBase *entry : section->entries()) {
+                const QString value = entry->value();
+                QString &known = m_values[qMakePair(section->name(), entry->name())];
+                if (known == value)
+                    continue;
+
+                qDebug() << "Configuration entry" << section->name() << entry->name() << "changed to" << value;
+                known = value;
+                changed = true;
+                emit entryChanged(section->name(), entry->name());
+            }
+        }
+
+        if (changed)
+            emit changed();
+    }
+}
@@ -0,0 +1,71 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_CONFIGNOTIFIER_H
+#define SDDM_CONFIGNOTIFIER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPair>
+
+class QSocketNotifier;
+class QTimer;
+
+namespace SDDM {
+    class ConfigBase;
+
+    // Reloads a configuration as soon as one of its files changes, or
+    // when asked to, and tells the subsystems which entries changed
+    class ConfigNotifier : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(ConfigNotifier)
+    public:
+        explicit ConfigNotifier(ConfigBase *config, QObject *parent = 0);
+
+    public slots:
+        // Reads the configuration again if one of its files changed, to be
+        // used instead of ConfigBase::load() so the changes are reported
+        void load();
+        // Reads the configuration again from scratch
+        void reload();
+
+    signals:
+        // Emitted right before the entries are rewritten, whoever reads
+        // them on another thread has to stop until the reload is done
+        void aboutToReload();
+        // The value of an entry changed, emitted once per entry
+        void entryChanged(const QString &section, const QString &name);
+        // Emitted after the entryChanged() signals of a reload
+        void changed();
+
+    private slots:
+        void activated();
+
+    private:
+        void compare();
+
+        ConfigBase *m_config { nullptr };
+        QSocketNotifier *m_notifier { nullptr };
+        QTimer *m_reloadTimer { nullptr };
+        // last known values by section and entry name
+        QHash<QPair<QString, QString>, QString> m_values;
+    };
+}
+
+#endif // SDDM_CONFIGNOTIFIER_H
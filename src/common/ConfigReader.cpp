@@ -27,6 +27,21 @@
 #include <QtCore/QMap>
 #include <QtCore/QBuffer>
 #include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+
+#include <errno.h>
+#include <string.h>
+
+#if defined(Q_OS_UNIX)
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <sys/inotify.h>
+#endif
 
 QTextStream &operator>>(QTextStream &str, QStringList &list)  {
     list.clear();
@@ -62,29 +77,62 @@ QTextStream &operator<<(QTextStream &str, const bool &val) {
 }
 
 namespace SDDM {
-    // has to be specialised because QTextStream reads only words into a QString
-    template <> void ConfigEntry<QString>::setValue(const QString &str) {
-        m_value = str.trimmed();
+    void parseConfigValue(const QStringRef &str, QString &value) {
+        value = str.trimmed().toString();
+    }
+
+    void parseConfigValue(const QStringRef &str, QStringList &value) {
+        value.clear();
+        int start = 0;
+        while (start <= str.size()) {
+            int end = str.indexOf(QLatin1Char(','), start);
+            if (end < 0)
+                end = str.size();
+            const QStringRef item = str.mid(start, end - start).trimmed();
+            if (!item.isEmpty())
+                value.append(item.toString());
+            start = end + 1;
+        }
+    }
+
+    void parseConfigValue(const QStringRef &str, bool &value) {
+        value = str.trimmed().compare(QLatin1String("true"), Qt::CaseInsensitive) == 0;
+    }
+
+    void parseConfigValue(const QStringRef &str, int &value) {
+        // same prefixes as QTextStream, 0 when it isn't a number
+        value = str.trimmed().toInt(nullptr, 0);
+    }
+
+    QString formatConfigValue(const QString &value) {
+        return value;
+    }
+
+    QString formatConfigValue(const QStringList &value) {
+        return value.join(QLatin1Char(','));
+    }
+
+    QString formatConfigValue(bool value) {
+        return value ? QStringLiteral("true") : QStringLiteral("false");
+    }
+
+    QString formatConfigValue(int value) {
+        return QString::number(value);
     }
 
 
     ConfigSection::ConfigSection(ConfigBase *parent, const QString &name) : m_parent(parent),
         m_name(name) {
         m_parent->m_sections.insert(name, this);
+        m_parent->m_sectionIndex.insert(name, this);
     }
 
     ConfigEntryBase *ConfigSection::entry(const QString &name) {
-        auto it = m_entries.find(name);
-        if (it != m_entries.end())
-            return it.value();
-        return nullptr;
+        return m_entryIndex.value(name, nullptr);
     }
 
     const ConfigEntryBase *ConfigSection::entry(const QString &name) const {
-        auto it = m_entries.find(name);
-        if (it != m_entries.end())
-            return it.value();
-        return nullptr;
+        return m_entryIndex.value(name, nullptr);
     }
 
     const QMap<QString, ConfigEntryBase*> &ConfigSection::entries() const {
@@ -101,11 +149,24 @@ namespace SDDM {
     }
 
     void ConfigSection::clear() {
+        m_origins.clear();
         for (auto it : m_entries) {
             it->setDefault();
         }
     }
 
+    void ConfigSection::assign(ConfigEntryBase *entry, const QStringRef &value, int source, int line) {
+        entry->setValue(value);
+        m_origins[entry] = { source, line };
+    }
+
+    QString ConfigSection::origin(const ConfigEntryBase *entry) const {
+        auto it = m_origins.constFind(entry);
+        if (it == m_origins.constEnd() || it->source < 0 || it->source >= m_parent->m_sources.size())
+            return QString();
+        return QStringLiteral("%1:%2").arg(m_parent->m_sources.at(it->source).first).arg(it->line);
+    }
+
     QString ConfigSection::toConfigFull() const {
         QString final = QStringLiteral("[%1]\n").arg(m_name);
         for (const ConfigEntryBase *entry : m_entries)
@@ -126,10 +187,139 @@ namespace SDDM {
     {
     }
 
+    ConfigBase::~ConfigBase() {
+#if defined(Q_OS_LINUX)
+        if (m_inotify != -1)
+            ::close(m_inotify);
+#endif
+    }
+
+    int ConfigBase::changeDescriptor() const {
+        return m_inotify;
+    }
+
+    bool ConfigBase::changesPending() const {
+        if (m_inotify == -1 || m_watchIncomplete)
+            return true;
+
+#if defined(Q_OS_UNIX)
+        struct pollfd fd = { m_inotify, POLLIN, 0 };
+        return poll(&fd, 1, 0) > 0;
+#else
+        return true;
+#endif
+    }
+
+    int ConfigBase::generation() const {
+        return m_generation;
+    }
+
+    void ConfigBase::watchFiles() {
+#if defined(Q_OS_LINUX)
+        static const uint32_t mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB |
+                                     IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+        if (m_inotify == -1) {
+            m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (m_inotify == -1) {
+                qWarning() << "Failed to watch the configuration files:" << strerror(errno);
+                return;
+            }
+        }
+
+        // events of the old watches are ignored from now on
+        for (auto it = m_watches.constBegin(); it != m_watches.constEnd(); ++it)
+            inotify_rm_watch(m_inotify, it.key());
+        m_watches.clear();
+        m_watchIncomplete = false;
+
+        auto watch = [this](const QString &path, const QString &name) {
+            const int wd = inotify_add_watch(m_inotify, QFile::encodeName(path).constData(), mask | IN_ONLYDIR);
+            if (wd == -1)
+                return false;
+            m_watches[wd] << name;
+            return true;
+        };
+
+        // the file itself may be replaced, watch its directory
+        const QFileInfo file(m_path);
+        m_watchIncomplete |= !watch(file.absolutePath(), file.fileName());
+
+        for (const QString &path : { m_sysConfigDir, m_configDir }) {
+            if (path.isEmpty())
+                continue;
+            // the directory may not exist yet, then the parent tells
+            // when it's created
+            const QFileInfo dir(QDir::cleanPath(path));
+            m_watchIncomplete |= !watch(dir.absolutePath(), dir.fileName());
+            if (dir.isDir())
+                m_watchIncomplete |= !watch(dir.absoluteFilePath(), QString());
+        }
+#endif
+    }
+
+    bool ConfigBase::filesChanged() {
+        bool changed = m_inotify == -1 || m_watchIncomplete;
+
+#if defined(Q_OS_LINUX)
+        if (m_inotify == -1)
+            return true;
+
+        alignas(struct inotify_event) char buffer[4096];
+        for (;;) {
+            const ssize_t length = read(m_inotify, buffer, sizeof(buffer));
+            if (length == -1 && errno == EINTR)
+                continue;
+            if (length <= 0)
+                break;
+
+            for (const char *p = buffer; p < buffer + length; ) {
+                const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(p);
+                p += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    changed = true;
+                    continue;
+                }
+
+                auto it = m_watches.constFind(event->wd);
+                if (it == m_watches.constEnd())
+                    continue;
+                const QString name = event->len ? QFile::decodeName(event->name) : QString();
+                for (const QString &filter : it.value()) {
+                    if (filter.isEmpty() || filter == name)
+                        changed = true;
+                }
+            }
+        }
+#endif
+
+        return changed;
+    }
+
     bool ConfigBase::hasUnused() const {
         return m_unusedSections || m_unusedVariables;
     }
 
+    QString ConfigBase::toConfigOrigins() const {
+        QString ret;
+        for (ConfigSection *s : m_sections) {
+            ret.append(s->toConfigShort());
+            ret.append(QLatin1Char('\n'));
+            for (const ConfigEntryBase *entry : s->entries()) {
+                const QString origin = s->origin(entry);
+                ret.append(QStringLiteral("%1 # %2\n").arg(entry->toConfigShort())
+                           .arg(origin.isEmpty() ? QStringLiteral("default") : origin));
+            }
+            ret.append(QLatin1Char('\n'));
+        }
+        return ret;
+    }
+
+    const QMap<QString, ConfigSection*> &ConfigBase::sections() const {
+        return m_sections;
+    }
+
     QString ConfigBase::toConfigFull() const {
         QString ret;
         for (ConfigSection *s : m_sections) {
@@ -139,7 +329,32 @@ namespace SDDM {
         return ret;
     }
 
-    void ConfigBase::load()
+    bool ConfigBase::load()
+    {
+        // nothing was touched since the last time, no need to look at the files
+        if (!filesChanged())
+            return false;
+        // watch before reading, a change made meanwhile triggers another load
+        watchFiles();
+
+        // the first time around the daemon may have done the work already
+        if (m_generation == 0 && loadSnapshot())
+            return true;
+
+        return readFiles(false);
+    }
+
+    void ConfigBase::reload()
+    {
+        // pending notifications are covered, everything is read anyway
+        filesChanged();
+        watchFiles();
+
+        wipe();
+        readFiles(true);
+    }
+
+    bool ConfigBase::readFiles(bool force)
     {
         //order of priority from least influence to most influence, is
         // * m_sysConfigDir (system settings /usr/lib/sddm/sddm.conf.d/) in alphabetical order
@@ -149,6 +364,16 @@ namespace SDDM {
         QStringList files;
         QDateTime latestModificationTime = QFileInfo(m_path).lastModified();
 
+        // what the snapshot depends on, the directories come first so that
+        // adding or removing a file is noticed without listing them
+        QVector<QPair<QString, qint64>> sources;
+        auto addSource = [&sources](const QString &path, const QDateTime &modified) {
+            sources << qMakePair(path, modified.isValid() ? modified.toMSecsSinceEpoch() : qint64(-1));
+        };
+        addSource(m_sysConfigDir, m_sysConfigDir.isEmpty() ? QDateTime() : QFileInfo(m_sysConfigDir).lastModified());
+        addSource(m_configDir, m_configDir.isEmpty() ? QDateTime() : QFileInfo(m_configDir).lastModified());
+        addSource(m_path, latestModificationTime);
+
         if (!m_sysConfigDir.isEmpty()) {
             //include the configDir in modification time so we also reload on any files added/removed
             QDir dir(m_sysConfigDir);
@@ -157,6 +382,7 @@ namespace SDDM {
                 foreach (const QFileInfo &file, dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot, QDir::LocaleAware)) {
                     files << (file.absoluteFilePath());
                     latestModificationTime = std::max(latestModificationTime, file.lastModified());
+                    addSource(file.absoluteFilePath(), file.lastModified());
                 }
             }
         }
@@ -168,56 +394,404 @@ namespace SDDM {
                 foreach (const QFileInfo &file, dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot, QDir::LocaleAware)) {
                     files << (file.absoluteFilePath());
                     latestModificationTime = std::max(latestModificationTime, file.lastModified());
+                    addSource(file.absoluteFilePath(), file.lastModified());
                 }
             }
         }
 
         files << m_path;
 
-        if (latestModificationTime <= m_fileModificationTime) {
-            return;
+        if (!force && latestModificationTime <= m_fileModificationTime) {
+            return false;
         }
         m_fileModificationTime = latestModificationTime;
+        m_sources = sources;
+        ++m_generation;
 
         foreach (const QString &filepath, files) {
-            loadInternal(filepath);
+            int source = sources.size() - 1;
+            while (source >= 0 && sources.at(source).first != filepath)
+                --source;
+            loadInternal(filepath, source);
+        }
+        markPersisted();
+
+        if (m_writeSnapshot)
+            writeSnapshot();
+
+        return true;
+    }
+
+    QString ConfigBase::snapshotPath() const {
+        return QString();
+    }
+
+    void ConfigBase::setWriteSnapshot(bool enabled) {
+        m_writeSnapshot = enabled;
+    }
+
+    /*
+     * The snapshot is made of the header followed by
+     *   SnapshotSource sources[sourceCount]
+     *   SnapshotEntry entries[entryCount]
+     *   QChar strings[stringsSize]
+     */
+    static const char s_snapshotMagic[8] = { 'S', 'D', 'D', 'M', 'C', 'F', 'G', '\0' };
+    static const quint32 s_snapshotVersion = 2;
+
+    struct SnapshotString {
+        quint32 offset;
+        quint32 length;
+    };
+
+    struct SnapshotHeader {
+        char magic[8];
+        quint32 version;
+        quint32 flags;
+        quint32 sourceCount;
+        quint32 entryCount;
+        qint64 latestModified;
+        quint32 stringsSize;
+        quint32 reserved;
+    };
+
+    struct SnapshotSource {
+        SnapshotString path;
+        qint64 modified;
+    };
+
+    struct SnapshotEntry {
+        SnapshotString section;
+        SnapshotString name;
+        SnapshotString value;
+        quint32 flags;
+        // where the value was read, -1 if it wasn't
+        qint32 source;
+        qint32 line;
+        quint32 reserved;
+    };
+
+    // SnapshotHeader::flags
+    static const quint32 UnusedVariablesFlag = 0x1;
+    // SnapshotEntry::flags
+    static const quint32 DefaultFlag = 0x1;
+
+    static qint64 modifiedTime(const QString &path) {
+        if (path.isEmpty())
+            return -1;
+        const QDateTime modified = QFileInfo(path).lastModified();
+        return modified.isValid() ? modified.toMSecsSinceEpoch() : -1;
+    }
+
+    bool ConfigBase::writeSnapshot() const {
+        const QString path = snapshotPath();
+        if (path.isEmpty() || m_sources.isEmpty())
+            return false;
+
+        QString strings;
+        auto addString = [&strings](const QString &str) -> SnapshotString {
+            SnapshotString ref;
+            ref.offset = quint32(strings.size());
+            ref.length = quint32(str.size());
+            strings.append(str);
+            return ref;
+        };
+
+        QVector<SnapshotSource> sources;
+        for (const auto &source : m_sources) {
+            SnapshotSource s;
+            s.path = addString(source.first);
+            s.modified = source.second;
+            sources << s;
+        }
+
+        QVector<SnapshotEntry> entries;
+        for (const ConfigSection *section : m_sections) {
+            for (const ConfigEntryBase *entry : section->entries()) {
+                SnapshotEntry e;
+                memset(&e, 0, sizeof(e));
+                e.section = addString(section->name());
+                e.name = addString(entry->name());
+                e.value = addString(entry->value());
+                // not every type tracks isDefault() when set from a file
+                e.flags = entry->isDefault() && entry->matchesDefault() ? DefaultFlag : 0;
+                auto origin = section->m_origins.constFind(entry);
+                e.source = origin != section->m_origins.constEnd() ? origin->source : -1;
+                e.line = origin != section->m_origins.constEnd() ? origin->line : -1;
+                entries << e;
+            }
         }
+
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, s_snapshotMagic, sizeof(header.magic));
+        header.version = s_snapshotVersion;
+        header.flags = m_unusedVariables ? UnusedVariablesFlag : 0;
+        header.sourceCount = quint32(sources.size());
+        header.entryCount = quint32(entries.size());
+        header.latestModified = m_fileModificationTime.isValid() ? m_fileModificationTime.toMSecsSinceEpoch() : -1;
+        header.stringsSize = quint32(strings.size());
+
+        QDir().mkpath(QFileInfo(path).path());
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Failed to write configuration snapshot" << path << file.errorString();
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(sources.constData()), sources.size() * sizeof(SnapshotSource));
+        file.write(reinterpret_cast<const char *>(entries.constData()), entries.size() * sizeof(SnapshotEntry));
+        file.write(reinterpret_cast<const char *>(strings.constData()), strings.size() * sizeof(QChar));
+
+        // the greeter runs as an unprivileged user
+        file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner |
+                            QFileDevice::ReadGroup | QFileDevice::ReadOther);
+
+        if (!file.commit()) {
+            qWarning() << "Failed to write configuration snapshot" << path << file.errorString();
+            return false;
+        }
+
+        return true;
     }
 
+    bool ConfigBase::loadSnapshot() {
+        const QString path = snapshotPath();
+        if (path.isEmpty())
+            return false;
+
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+
+        const qint64 size = file.size();
+        if (size < qint64(sizeof(SnapshotHeader)))
+            return false;
+
+        uchar *data = file.map(0, size);
+        if (!data)
+            return false;
+
+        // unmaps on every way out
+        struct Unmap {
+            QFile &file;
+            uchar *data;
+            ~Unmap() { file.unmap(data); }
+        } unmap { file, data };
+
+        const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(data);
+        if (memcmp(header->magic, s_snapshotMagic, sizeof(s_snapshotMagic)) != 0 || header->version != s_snapshotVersion ||
+                header->sourceCount < 3 ||
+                size != qint64(sizeof(SnapshotHeader)) + qint64(header->sourceCount) * sizeof(SnapshotSource)
+                        + qint64(header->entryCount) * sizeof(SnapshotEntry) + qint64(header->stringsSize) * sizeof(QChar))
+            return false;
+
+        const SnapshotSource *sources = reinterpret_cast<const SnapshotSource *>(data + sizeof(SnapshotHeader));
+        const SnapshotEntry *entries = reinterpret_cast<const SnapshotEntry *>(sources + header->sourceCount);
+        const QChar *strings = reinterpret_cast<const QChar *>(entries + header->entryCount);
+        auto string = [header, strings](const SnapshotString &ref) -> QString {
+            if (quint64(ref.offset) + ref.length > header->stringsSize)
+                return QString();
+            return QString::fromRawData(strings + ref.offset, int(ref.length));
+        };
 
-    void ConfigBase::loadInternal(const QString &filepath) {
-        QString currentSection = QStringLiteral(IMPLICIT_SECTION);
+        // written for this configuration and none of the files changed
+        // since, a few stat calls instead of listing the directories
+        const QString roots[] = { m_sysConfigDir, m_configDir, m_path };
+        QVector<QPair<QString, qint64>> current;
+        for (quint32 i = 0; i < header->sourceCount; ++i) {
+            const QString source = string(sources[i].path);
+            if (i < 3 && source != roots[i])
+                return false;
+            const qint64 modified = modifiedTime(source);
+            if (modified != sources[i].modified)
+                return false;
+            current << qMakePair(QString(source.constData(), source.size()), modified);
+        }
+
+        // every entry must be accounted for before anything is touched
+        int total = 0;
+        for (const ConfigSection *section : m_sections)
+            total += section->entries().size();
+        if (header->entryCount != quint32(total))
+            return false;
+
+        QVector<QPair<ConfigSection *, ConfigEntryBase *>> resolved;
+        resolved.reserve(total);
+        for (quint32 i = 0; i < header->entryCount; ++i) {
+            ConfigSection *section = m_sectionIndex.value(string(entries[i].section), nullptr);
+            ConfigEntryBase *entry = section ? section->entry(string(entries[i].name)) : nullptr;
+            if (!entry)
+                return false;
+            resolved << qMakePair(section, entry);
+        }
+
+        for (quint32 i = 0; i < header->entryCount; ++i) {
+            if (entries[i].flags & DefaultFlag) {
+                resolved[i].second->setDefault();
+            } else {
+                // the mapping goes away, entries mustn't share it
+                const QString mapped = string(entries[i].value);
+                const QString value(mapped.constData(), mapped.size());
+                resolved[i].first->assign(resolved[i].second, QStringRef(&value),
+                                          entries[i].source, entries[i].line);
+            }
+        }
+
+        m_unusedVariables = header->flags & UnusedVariablesFlag;
+        m_fileModificationTime = header->latestModified == -1 ? QDateTime() : QDateTime::fromMSecsSinceEpoch(header->latestModified);
+        m_sources = current;
+        ++m_generation;
+        markPersisted();
+
+        return true;
+    }
+
+
+    void ConfigBase::loadInternal(const QString &filepath, int source) {
+        ConfigSection *currentSection = m_sectionIndex.value(QStringLiteral(IMPLICIT_SECTION), nullptr);
 
         QFile in(filepath);
 
         if (!in.open(QIODevice::ReadOnly))
             return;
-        while (!in.atEnd()) {
-            QString line = QString::fromUtf8(in.readLine());
-            QStringRef lineRef = QStringRef(&line).trimmed();
+        // decoded at once, lines and names are only referenced from then on
+        const QString contents = QString::fromUtf8(in.readAll());
+        QString key;
+
+        int start = 0;
+        int lineNumber = 0;
+        while (start < contents.size()) {
+            int end = contents.indexOf(QLatin1Char('\n'), start);
+            if (end < 0)
+                end = contents.size();
+            QStringRef lineRef = contents.midRef(start, end - start).trimmed();
+            start = end + 1;
+            ++lineNumber;
             // get rid of comments first
             lineRef = lineRef.left(lineRef.indexOf(QLatin1Char('#'))).trimmed();
 
             // value assignment
             int separatorPosition = lineRef.indexOf(QLatin1Char('='));
             if (separatorPosition >= 0) {
-                QString name = lineRef.left(separatorPosition).trimmed().toString();
+                const QStringRef name = lineRef.left(separatorPosition).trimmed();
                 QStringRef value = lineRef.mid(separatorPosition + 1).trimmed();
 
-                auto sectionIterator = m_sections.constFind(currentSection);
-                if (sectionIterator != m_sections.constEnd() && sectionIterator.value()->entry(name))
-                    sectionIterator.value()->entry(name)->setValue(value.toString());
+                key.setRawData(name.unicode(), name.size());
+                ConfigEntryBase *entry = currentSection ? currentSection->entry(key) : nullptr;
+                if (entry)
+                    currentSection->assign(entry, value, source, lineNumber);
                 else
                     // if we don't have such member in the config, nag about it
                     m_unusedVariables = true;
             }
             // section start
-            else if (lineRef.startsWith(QLatin1Char('[')) && lineRef.endsWith(QLatin1Char(']')))
-                currentSection = lineRef.mid(1, lineRef.length() - 2).toString();
+            else if (lineRef.startsWith(QLatin1Char('[')) && lineRef.endsWith(QLatin1Char(']'))) {
+                const QStringRef name = lineRef.mid(1, lineRef.length() - 2);
+                key.setRawData(name.unicode(), name.size());
+                currentSection = m_sectionIndex.value(key, nullptr);
+                if (!currentSection)
+                    m_unusedSections = true;
+            }
+        }
+    }
+
+    bool ConfigBase::isDirty() const {
+        for (auto it = m_persisted.constBegin(); it != m_persisted.constEnd(); ++it) {
+            if (it.key()->value() != it.value())
+                return true;
+        }
+        return false;
+    }
+
+    void ConfigBase::markPersisted() {
+        for (const ConfigSection *s : m_sections) {
+            for (const ConfigEntryBase *e : s->entries())
+                m_persisted[e] = e->value();
         }
     }
 
+    const QString &ConfigBase::path() const {
+        return m_path;
+    }
+
+    bool ConfigBase::writeFile(const QString &path, const QByteArray &data) {
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Failed to write" << path << file.errorString();
+            return false;
+        }
+
+#if defined(Q_OS_UNIX)
+        // the replacement belongs to whoever owned the file
+        struct stat st;
+        if (::stat(QFile::encodeName(path).constData(), &st) == 0 && fchown(file.handle(), st.st_uid, st.st_gid) != 0)
+            qWarning() << "Failed to keep the owner of" << path << strerror(errno);
+#endif
+
+        file.write(data);
+
+#if defined(Q_OS_UNIX)
+        // on disk before it replaces the old one, a crash leaves either
+        file.flush();
+        if (fsync(file.handle()) != 0)
+            qWarning() << "Failed to sync" << path << strerror(errno);
+#endif
+
+        if (!file.commit()) {
+            qWarning() << "Failed to write" << path << file.errorString();
+            return false;
+        }
+
+#if defined(Q_OS_UNIX)
+        // and the rename too
+        const int dir = ::open(QFile::encodeName(QFileInfo(path).absolutePath()).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir != -1) {
+            fsync(dir);
+            ::close(dir);
+        }
+#endif
+
+        return true;
+    }
+
     void ConfigBase::save(const ConfigSection *section, const ConfigEntryBase *entry) {
+        const SaveValues values = saveValues(section, entry);
+        QByteArray data;
+        if (prepareSave(values, &data) && writeFile(m_path, data))
+            markPersisted(values);
+    }
+
+    ConfigBase::SaveValues ConfigBase::saveValues(const ConfigSection *section, const ConfigEntryBase *entry) const {
+        SaveValues values;
+        values.section = section;
+        values.entry = entry;
+        for (const ConfigSection *s : m_sections) {
+            for (const ConfigEntryBase *e : s->entries()) {
+                values.values[e] = e->value();
+                if (!e->matchesDefault())
+                    values.changed[e] = e->toConfigFull();
+            }
+        }
+        return values;
+    }
+
+    void ConfigBase::markPersisted(const SaveValues &values) {
+        for (const ConfigSection *s : m_sections) {
+            if (values.section && s != values.section)
+                continue;
+            for (const ConfigEntryBase *e : s->entries()) {
+                if (!values.entry || e == values.entry)
+                    m_persisted[e] = values.values.value(e);
+            }
+        }
+    }
+
+    bool ConfigBase::prepareSave(const SaveValues &values, QByteArray *data) const {
+        const ConfigSection *section = values.section;
+        const ConfigEntryBase *entry = values.entry;
+
         // to know if we should overwrite the config or not
         bool changed = false;
         // stores the order of the loaded sections
@@ -233,17 +807,17 @@ namespace SDDM {
          * Initialization of the map of nondefault values to be saved
          */
         if (section) {
-            if (entry && !entry->matchesDefault())
+            if (entry && values.changed.contains(entry))
                 remainingEntries.insert(section, entry);
             else
                 for (const ConfigEntryBase *b : section->entries().values())
-                    if (!b->matchesDefault())
+                    if (values.changed.contains(b))
                         remainingEntries.insert(section, b);
         }
         else {
             for (const ConfigSection *s : m_sections)
                 for (const ConfigEntryBase *b : s->entries().values())
-                    if (!b->matchesDefault())
+                    if (values.changed.contains(b))
                         remainingEntries.insert(s, b);
         }
 
@@ -285,21 +859,21 @@ namespace SDDM {
                 QString name = trimmedLine.left(separatorPosition).trimmed().toString();
                 QStringRef value = trimmedLine.mid(separatorPosition + 1).trimmed();
 
-                if (currentSection && currentSection->entry(name)) {
+                const ConfigEntryBase *current = currentSection ? currentSection->entry(name) : nullptr;
+                if (current) {
+                    const QString currentValue = values.values.value(current);
                     // this monstrous condition checks the parameters if only one entry/section should be saved
                     if ((entry && section && section->name() == currentSection->name() && entry->name() == name) ||
                         (!entry && section && section->name() == currentSection->name()) ||
-                        value != currentSection->entry(name)->value()) {
+                        value != currentValue) {
                         changed = true;
-                        writeSectionData(QStringLiteral("%1=%2 %3\n").arg(name).arg(currentSection->entry(name)->value()).arg(comment.toString()));
+                        writeSectionData(QStringLiteral("%1=%2 %3\n").arg(name).arg(currentValue).arg(comment.toString()));
                     }
                     else
                         writeSectionData(line);
-                    remainingEntries.remove(currentSection, currentSection->entry(name));
+                    remainingEntries.remove(currentSection, current);
                 }
                 else {
-                    if (currentSection)
-                        m_unusedVariables = true;
                     writeSectionData(QStringLiteral("%1 %2\n").arg(trimmedLine.toString()).arg(QStringLiteral(UNUSED_VARIABLE_COMMENT)));
                 }
             }
@@ -314,7 +888,6 @@ namespace SDDM {
                         writeSectionData(line);
                 }
                 else {
-                    m_unusedSections = true;
                     currentSection = nullptr;
                     writeSectionData(line);
                 }
@@ -334,22 +907,25 @@ namespace SDDM {
             if (!sectionOrder.contains(currentSection))
                 writeSectionData(currentSection->toConfigShort());
             writeSectionData(QStringLiteral("\n"));
-            writeSectionData(it.value()->toConfigFull());
+            writeSectionData(values.changed.value(it.value()));
         }
 
         // rewrite the whole thing only if there are changes
-        if (changed) {
-            file.open(QIODevice::WriteOnly | QIODevice::Truncate);
-            for (const ConfigSection *s : sectionOrder)
-                file.write(sectionData.value(s));
-
-            if (sectionData.contains(nullptr)) {
-                file.write("\n");
-                file.write(UNUSED_SECTION_COMMENT);
-                file.write(sectionData.value(nullptr).trimmed());
-                file.write("\n");
-            }
+        if (!changed)
+            return false;
+
+        data->clear();
+        for (const ConfigSection *s : sectionOrder)
+            data->append(sectionData.value(s));
+
+        if (sectionData.contains(nullptr)) {
+            data->append("\n");
+            data->append(UNUSED_SECTION_COMMENT);
+            data->append(sectionData.value(nullptr).trimmed());
+            data->append("\n");
         }
+
+        return true;
     }
 
     void ConfigBase::wipe() {
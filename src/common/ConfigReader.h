@@ -27,6 +27,9 @@
 #include <QtCore/QDebug>
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QVector>
 
 #define IMPLICIT_SECTION "General"
 #define UNUSED_VARIABLE_COMMENT "# Unused variable"
@@ -71,11 +74,40 @@ namespace SDDM {
     class ConfigSection;
     class ConfigBase;
 
+    // conversions between entry values and their text in the files, the
+    // common types are handled directly and anything else goes through
+    // its QTextStream operators. Overloads for other types are picked up
+    // from the namespace of the type.
+    void parseConfigValue(const QStringRef &str, QString &value);
+    void parseConfigValue(const QStringRef &str, QStringList &value);
+    void parseConfigValue(const QStringRef &str, bool &value);
+    void parseConfigValue(const QStringRef &str, int &value);
+    QString formatConfigValue(const QString &value);
+    QString formatConfigValue(const QStringList &value);
+    QString formatConfigValue(bool value);
+    QString formatConfigValue(int value);
+
+    template <class T>
+    void parseConfigValue(const QStringRef &str, T &value) {
+        QString text = str.toString();
+        QTextStream in(&text, QIODevice::ReadOnly);
+        in >> value;
+    }
+
+    template <class T>
+    QString formatConfigValue(const T &value) {
+        QString str;
+        QTextStream out(&str);
+        out << value;
+        return str;
+    }
+
     class ConfigEntryBase {
     public:
         virtual const QString &name() const = 0;
         virtual QString value() const = 0;
         virtual void setValue(const QString &str) = 0;
+        virtual void setValue(const QStringRef &str) = 0;
         virtual QString toConfigShort() const = 0;
         virtual QString toConfigFull() const = 0;
         virtual bool matchesDefault() const = 0;
@@ -94,13 +126,29 @@ namespace SDDM {
         QString toConfigShort() const;
         QString toConfigFull() const;
         const QMap<QString, ConfigEntryBase*> &entries() const;
+        // File and line the value of an entry was read from, empty if it
+        // wasn't read from a file
+        QString origin(const ConfigEntryBase *entry) const;
     private:
+        struct Origin {
+            // index into the sources of the configuration
+            int source;
+            int line;
+        };
+
+        // sets an entry to a value read from a file
+        void assign(ConfigEntryBase *entry, const QStringRef &value, int source, int line);
+
         template<class T> friend class ConfigEntryPrivate;
+        // ordered for writing the files, hashed for looking entries up
         QMap<QString, ConfigEntryBase*> m_entries {};
+        QHash<QString, ConfigEntryBase*> m_entryIndex {};
+        QHash<const ConfigEntryBase*, Origin> m_origins {};
 
         ConfigBase *m_parent { nullptr };
         QString m_name { };
         template<class T> friend class ConfigEntry;
+        friend class ConfigBase;
     };
 
     template <class T>
@@ -114,6 +162,7 @@ namespace SDDM {
             m_isDefault(true),
             m_parent(parent) {
             m_parent->m_entries[name] = this;
+            m_parent->m_entryIndex[name] = this;
         }
 
         T get() const {
@@ -121,6 +170,7 @@ namespace SDDM {
         }
 
         void set(const T val) {
+            m_parent->m_origins.remove(this);
             m_value = val;
             m_isDefault = false;
         }
@@ -134,6 +184,7 @@ namespace SDDM {
         }
 
         bool setDefault() {
+            m_parent->m_origins.remove(this);
             m_isDefault = true;
             if (m_value == m_default)
                 return false;
@@ -150,17 +201,16 @@ namespace SDDM {
         }
 
         QString value() const {
-            QString str;
-            QTextStream out(&str);
-            out << m_value;
-            return str;
+            return formatConfigValue(m_value);
         }
 
-        // specialised for QString
         void setValue(const QString &str) {
+            setValue(QStringRef(&str));
+        }
+
+        void setValue(const QStringRef &str) {
             m_isDefault = false;
-            QTextStream in(qPrintable(str));
-            in >> m_value;
+            parseConfigValue(str, m_value);
         }
 
         QString toConfigShort() const {
@@ -187,12 +237,64 @@ namespace SDDM {
     class ConfigBase {
     public:
         ConfigBase(const QString &configPath, const QString &configDir=QString(), const QString &sysConfigDir=QString());
+        virtual ~ConfigBase();
 
-        void load();
+        // Reads the files again if they changed, returns whether it did.
+        // Once a ConfigNotifier watches the configuration, use its load()
+        // instead, changes read here wouldn't be reported.
+        bool load();
+        // Reads the files again from scratch, entries that aren't set
+        // anymore get their default value back
+        void reload();
         void save(const ConfigSection *section = nullptr, const ConfigEntryBase *entry = nullptr);
+        // The text of every entry at one point in time, what a save writes
+        struct SaveValues {
+            const ConfigSection *section { nullptr };
+            const ConfigEntryBase *entry { nullptr };
+            QHash<const ConfigEntryBase*, QString> values;
+            // entries that don't match their default, as they are
+            // appended when the file doesn't have them yet
+            QHash<const ConfigEntryBase*, QString> changed;
+        };
+        // Takes the values to save, all of them or those of a section or
+        // a single entry
+        SaveValues saveValues(const ConfigSection *section = nullptr, const ConfigEntryBase *entry = nullptr) const;
+        // Merges the values into the contents of the main file without
+        // writing it, returns false if the file wouldn't change. Doesn't
+        // touch the entries, the file can be read on another thread.
+        bool prepareSave(const SaveValues &values, QByteArray *data) const;
+        // Records saved values as what the file has, once it is written
+        void markPersisted(const SaveValues &values);
+        // Whether an entry differs from what the files had when they were
+        // last read or saved
+        bool isDirty() const;
+        const QString &path() const;
+        // Replaces a file atomically, the data is synced to disk before
+        // the rename
+        static bool writeFile(const QString &path, const QByteArray &data);
         void wipe();
         bool hasUnused() const;
         QString toConfigFull() const;
+        // Every entry with its value and where the value comes from
+        QString toConfigOrigins() const;
+        const QMap<QString, ConfigSection*> &sections() const;
+        // Descriptor that becomes readable when one of the files changes,
+        // -1 if changes can't be watched
+        int changeDescriptor() const;
+        // Whether load() could find changes, without consuming the
+        // notifications
+        bool changesPending() const;
+        // Incremented every time the files are read
+        int generation() const;
+
+        // Binary copy of the merged configuration, kept up to date by the
+        // daemon and used by the other processes instead of the files for
+        // as long as none of them changed. Empty if there is none.
+        virtual QString snapshotPath() const;
+        // Writes the snapshot every time the files are read
+        void setWriteSnapshot(bool enabled);
+        // Writes the snapshot of what was read last, returns whether it did
+        bool writeSnapshot() const;
     protected:
         bool m_unusedVariables { false };
         bool m_unusedSections { false };
@@ -201,11 +303,30 @@ namespace SDDM {
         QString m_configDir;
         QString m_sysConfigDir;
         QMap<QString, ConfigSection*> m_sections;
+        QHash<QString, ConfigSection*> m_sectionIndex;
         friend class ConfigSection;
     private:
         QDateTime dirLatestModifiedTime(const QString &directory);
-        void loadInternal(const QString &filepath);
+        bool readFiles(bool force);
+        bool loadSnapshot();
+        void loadInternal(const QString &filepath, int source);
+        bool filesChanged();
+        void watchFiles();
+        void markPersisted();
         QDateTime m_fileModificationTime;
+        int m_generation { 0 };
+        // paths and modification times of what was read last, -1 for
+        // missing ones
+        QVector<QPair<QString, qint64>> m_sources;
+        bool m_writeSnapshot { false };
+        // values as the files have them
+        QHash<const ConfigEntryBase *, QString> m_persisted;
+        // inotify instance and the names each of its watches is interested
+        // in, an empty name stands for anything in the directory
+        int m_inotify { -1 };
+        QHash<int, QStringList> m_watches;
+        // some files couldn't be watched, check them every time
+        bool m_watchIncomplete { true };
     };
 }
 
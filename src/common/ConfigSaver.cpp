@@ -0,0 +1,105 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "ConfigSaver.h"
+
+#include <QDebug>
+#include <QRunnable>
+#include <QTimer>
+
+namespace SDDM {
+    // logins on several seats at once are written together
+    static const int s_saveDelay = 1000;
+    // a full disk or a read-only mount doesn't go away right away
+    static const int s_retryDelay = 30000;
+
+    // Merges the values into the file and writes it, the values were
+    // taken on the event loop and the entries aren't touched here
+    class ConfigWriteJob : public QRunnable {
+    public:
+        ConfigWriteJob(ConfigSaver *saver, const ConfigBase *config, int id, const ConfigBase::SaveValues &values)
+            : m_saver(saver), m_config(config), m_id(id), m_values(values) { }
+
+        void run() override {
+            QByteArray data;
+            bool success = true;
+            if (m_config->prepareSave(m_values, &data))
+                success = ConfigBase::writeFile(m_config->path(), data);
+
+            // the saver waits for the pool before going away
+            QMetaObject::invokeMethod(m_saver, "written", Qt::QueuedConnection,
+                                      Q_ARG(int, m_id), Q_ARG(bool, success));
+        }
+
+    private:
+        ConfigSaver *m_saver { nullptr };
+        const ConfigBase *m_config { nullptr };
+        int m_id { 0 };
+        ConfigBase::SaveValues m_values;
+    };
+
+    ConfigSaver::ConfigSaver(ConfigBase *config, QObject *parent) : QObject(parent), m_config(config) {
+        m_pool.setMaxThreadCount(1);
+
+        m_saveTimer = new QTimer(this);
+        m_saveTimer->setSingleShot(true);
+        connect(m_saveTimer, &QTimer::timeout, this, &ConfigSaver::flush);
+    }
+
+    ConfigSaver::~ConfigSaver() {
+        if (m_saveTimer->isActive())
+            flush();
+        m_pool.waitForDone();
+    }
+
+    void ConfigSaver::save() {
+        if (!m_saveTimer->isActive())
+            m_saveTimer->start(s_saveDelay);
+    }
+
+    void ConfigSaver::flush() {
+        m_saveTimer->stop();
+
+        if (!m_config->isDirty())
+            return;
+
+        // only the values are taken here, the file is read and merged
+        // along with the write
+        const int id = ++m_lastId;
+        m_writing[id] = m_config->saveValues();
+
+        qDebug() << "Saving" << m_config->path();
+        m_pool.start(new ConfigWriteJob(this, m_config, id, m_writing[id]));
+    }
+
+    void ConfigSaver::written(int id, bool success) {
+        const ConfigBase::SaveValues values = m_writing.take(id);
+
+        if (!success) {
+            // the entries stay dirty until a write makes it
+            qWarning() << "Saving" << m_config->path() << "failed, trying again in" << s_retryDelay / 1000 << "seconds";
+            if (!m_saveTimer->isActive())
+                m_saveTimer->start(s_retryDelay);
+            return;
+        }
+
+        // entries changed since then are still dirty
+        m_config->markPersisted(values);
+    }
+}
@@ -0,0 +1,63 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_CONFIGSAVER_H
+#define SDDM_CONFIGSAVER_H
+
+#include <QHash>
+#include <QObject>
+#include <QThreadPool>
+
+#include "ConfigReader.h"
+
+class QTimer;
+
+namespace SDDM {
+    // Saves a configuration off the event loop, several requests in a
+    // row end up as a single write and nothing is written if no entry
+    // changed. A write that fails is tried again later.
+    class ConfigSaver : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(ConfigSaver)
+    public:
+        explicit ConfigSaver(ConfigBase *config, QObject *parent = 0);
+        // Writes what is pending and waits for it
+        ~ConfigSaver();
+
+    public slots:
+        // Schedules a save
+        void save();
+        // Starts the pending save right away
+        void flush();
+
+    private slots:
+        void written(int id, bool success);
+
+    private:
+        ConfigBase *m_config { nullptr };
+        QTimer *m_saveTimer { nullptr };
+        // what each write in progress saves, by id
+        QHash<int, ConfigBase::SaveValues> m_writing;
+        int m_lastId { 0 };
+        // a single thread keeps the writes in order
+        QThreadPool m_pool;
+    };
+}
+
+#endif // SDDM_CONFIGSAVER_H
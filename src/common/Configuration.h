@@ -36,6 +36,8 @@ namespace SDDM {
     Config(MainConfig, QStringLiteral(CONFIG_FILE), QStringLiteral(CONFIG_DIR), QStringLiteral(SYSTEM_CONFIG_DIR),
         enum NumState { NUM_NONE, NUM_SET_ON, NUM_SET_OFF };
 
+        QString snapshotPath() const override { return QStringLiteral(RUNTIME_DIR "/sddm.conf.cache"); }
+
         //  Name                   Type         Default value                                   Description
         Entry(HaltCommand,         QString,     _S(HALT_COMMAND),                               _S("Halt command"));
         Entry(RebootCommand,       QString,     _S(REBOOT_COMMAND),                             _S("Reboot command"));
@@ -53,7 +55,11 @@ namespace SDDM {
             Entry(EnableAvatars,       bool,        true,                                       _S("Enable display of custom user avatars"));
             Entry(DisableAvatarsThreshold,int,      7,                                          _S("Number of users to use as threshold\n"
                                                                                                    "above which avatars are disabled\n"
-                                                                                                   "unless explicitly enabled with EnableAvatars"));
+                                                                                                   "unless explicitly enabled with EnableAvatars.\n"
+                                                                                                   "Only applies when set explicitly"));
+            Entry(IdleTimeout,         int,         300,                                        _S("Number of seconds without input after which the greeter\n"
+                                                                                                   "is idle and themes stop their animations.\n"
+                                                                                                   "Set to 0 to never become idle"));
         );
 
         // TODO: Not absolutely sure if everything belongs here. Xsessions, VT and probably some more seem universal
@@ -83,9 +89,16 @@ namespace SDDM {
             Entry(DefaultPath,         QString,     _S("/usr/local/bin:/usr/bin:/bin"),         _S("Default $PATH for logged in users"));
             Entry(MinimumUid,          int,         UID_MIN,                                    _S("Minimum user id for displayed users"));
             Entry(MaximumUid,          int,         UID_MAX,                                    _S("Maximum user id for displayed users"));
-            Entry(HideUsers,           QStringList, QStringList(),                              _S("Comma-separated list of users that should not be listed"));
+            Entry(HideUsers,           QStringList, QStringList(),                              _S("Comma-separated list of users that should not be listed.\n"
+                                                                                                   "Entries can be shell wildcards or /regular expressions/"));
             Entry(HideShells,          QStringList, QStringList(),                              _S("Comma-separated list of shells.\n"
-                                                                                                   "Users with these shells as their default won't be listed"));
+                                                                                                   "Users with these shells as their default won't be listed.\n"
+                                                                                                   "Entries can be shell wildcards or /regular expressions/"));
+            Entry(HideGroups,          QStringList, QStringList(),                              _S("Comma-separated list of groups.\n"
+                                                                                                   "Members of these groups won't be listed"));
+            Entry(CacheTimeout,        int,         600,                                        _S("Number of seconds the daemon's snapshot of the user list stays valid.\n"
+                                                                                                   "The snapshot is also refreshed whenever the user database changes.\n"
+                                                                                                   "Set to 0 to let the greeter enumerate users by itself"));
             Entry(RememberLastUser,    bool,        true,                                       _S("Remember the last successfully logged in user"));
             Entry(RememberLastSession, bool,        true,                                       _S("Remember the session of the last successfully logged in user"));
 
@@ -111,25 +124,23 @@ namespace SDDM {
     extern MainConfig mainConfig;
     extern StateConfig stateConfig;
 
-    inline QTextStream& operator>>(QTextStream &str, MainConfig::NumState &state) {
-        QString text = str.readLine().trimmed();
+    inline void parseConfigValue(const QStringRef &str, MainConfig::NumState &state) {
+        const QStringRef text = str.trimmed();
         if (text.compare(QLatin1String("on"), Qt::CaseInsensitive) == 0)
             state = MainConfig::NUM_SET_ON;
         else if (text.compare(QLatin1String("off"), Qt::CaseInsensitive) == 0)
             state = MainConfig::NUM_SET_OFF;
         else
             state = MainConfig::NUM_NONE;
-        return str;
     }
 
-    inline QTextStream& operator<<(QTextStream &str, const MainConfig::NumState &state) {
+    inline QString formatConfigValue(MainConfig::NumState state) {
         if (state == MainConfig::NUM_SET_ON)
-            str << "on";
+            return QStringLiteral("on");
         else if (state == MainConfig::NUM_SET_OFF)
-            str << "off";
+            return QStringLiteral("off");
         else
-            str << "none";
-        return str;
+            return QStringLiteral("none");
     }
 }
 
@@ -0,0 +1,349 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "DesktopEntry.h"
+
+#include <limits>
+#include <string.h>
+
+namespace SDDM {
+    static inline bool isSpace(char c) {
+        return c == ' ' || c == '\t';
+    }
+
+    static const char *skipSpace(const char *p, const char *end) {
+        while (p < end && isSpace(*p))
+            ++p;
+        return p;
+    }
+
+    static const char *trimRight(const char *begin, const char *end) {
+        while (end > begin && isSpace(end[-1]))
+            --end;
+        return end;
+    }
+
+    static const char *lineEnd(const char *p, const char *end) {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+        return eol ? eol : end;
+    }
+
+    // An odd number of trailing backslashes continues the value
+    static bool continues(const char *begin, const char *end) {
+        int count = 0;
+        while (end > begin && end[-1] == '\\') {
+            --end;
+            ++count;
+        }
+        return count % 2 == 1;
+    }
+
+    // Expands escape sequences and joins continued lines, splitting on
+    // unescaped semicolons if requested
+    static QStringList unescape(const char *p, const char *end, bool split) {
+        QStringList result;
+
+        // common case, nothing to expand
+        if (!memchr(p, '\\', end - p) && (!split || !memchr(p, ';', end - p))) {
+            if (p < end || !split)
+                result << QString::fromUtf8(p, int(end - p));
+            return result;
+        }
+
+        QByteArray current;
+        current.reserve(int(end - p));
+        for (; p < end; ++p) {
+            if (*p == ';' && split) {
+                result << QString::fromUtf8(current);
+                current.clear();
+                continue;
+            }
+            if (*p != '\\' || p + 1 == end) {
+                current += *p;
+                continue;
+            }
+            switch (*++p) {
+            case 's': current += ' '; break;
+            case 'n': current += '\n'; break;
+            case 't': current += '\t'; break;
+            case 'r': current += '\r'; break;
+            case '\\': current += '\\'; break;
+            case ';':
+                // only lists give the semicolon a meaning
+                if (!split)
+                    current += '\\';
+                current += ';';
+                break;
+            case '\r':
+            case '\n':
+                // continuation, drop the line break and the indentation
+                if (*p == '\r' && p + 1 < end && p[1] == '\n')
+                    ++p;
+                p = skipSpace(p + 1, end) - 1;
+                break;
+            default:
+                current += '\\';
+                current += *p;
+                break;
+            }
+        }
+        if (!current.isEmpty() || !split)
+            result << QString::fromUtf8(current);
+
+        return result;
+    }
+
+    DesktopEntry::DesktopEntry(const QString &group) : m_group(group), m_locale(systemLocale()) {
+    }
+
+    DesktopEntry::~DesktopEntry() {
+        close();
+    }
+
+    void DesktopEntry::close() {
+        // m_data may point into the mapping
+        m_data.clear();
+        m_items.clear();
+        m_valid = false;
+        if (m_map)
+            m_file.unmap(m_map);
+        m_map = nullptr;
+        m_file.close();
+    }
+
+    bool DesktopEntry::load(const QString &path) {
+        close();
+
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::ReadOnly))
+            return false;
+
+        const qint64 size = m_file.size();
+        if (size <= 0 || size > std::numeric_limits<int>::max()) {
+            m_file.close();
+            return size == 0 && parse(QByteArray());
+        }
+
+        m_map = m_file.map(0, size);
+        if (!m_map) {
+            const QByteArray data = m_file.readAll();
+            m_file.close();
+            return parse(data);
+        }
+
+        return parse(QByteArray::fromRawData(reinterpret_cast<const char *>(m_map), int(size)));
+    }
+
+    bool DesktopEntry::parse(const QByteArray &data) {
+        m_items.clear();
+        m_valid = false;
+        m_data = data;
+
+        const QByteArray group = m_group.toUtf8();
+        const char *begin = m_data.constData();
+        const char *end = begin + m_data.size();
+        bool inGroup = false;
+
+        for (const char *line = begin; line < end; ) {
+            const char *eol = lineEnd(line, end);
+            const char *next = eol < end ? eol + 1 : end;
+            if (eol > line && eol[-1] == '\r')
+                --eol;
+
+            const char *p = skipSpace(line, eol);
+            if (p == eol || *p == '#') {
+                line = next;
+                continue;
+            }
+
+            if (*p == '[') {
+                // there is only one group we care about
+                if (inGroup)
+                    break;
+                const char *close = trimRight(p, eol);
+                inGroup = close[-1] == ']' && close - p - 2 == group.size() &&
+                          memcmp(p + 1, group.constData(), group.size()) == 0;
+                m_valid |= inGroup;
+                line = next;
+                continue;
+            }
+
+            const char *equal = inGroup ? static_cast<const char *>(memchr(p, '=', eol - p)) : nullptr;
+            if (!equal) {
+                line = next;
+                continue;
+            }
+
+            Item item;
+            const char *keyEnd = trimRight(p, equal);
+            item.key = int(p - begin);
+            item.keyLength = int(keyEnd - p);
+            item.locale = 0;
+            item.localeLength = 0;
+            if (keyEnd > p && keyEnd[-1] == ']') {
+                const char *open = static_cast<const char *>(memchr(p, '[', keyEnd - p));
+                if (open) {
+                    item.keyLength = int(open - p);
+                    item.locale = int(open + 1 - begin);
+                    item.localeLength = int(keyEnd - open - 2);
+                }
+            }
+
+            const char *value = skipSpace(equal + 1, eol);
+            const char *valueEnd = eol;
+            while (continues(value, valueEnd) && next < end) {
+                valueEnd = lineEnd(next, end);
+                next = valueEnd < end ? valueEnd + 1 : end;
+                if (valueEnd > value && valueEnd[-1] == '\r')
+                    --valueEnd;
+            }
+            item.value = int(value - begin);
+            item.valueLength = int(valueEnd - value);
+
+            m_items.append(item);
+            line = next;
+        }
+
+        return m_valid;
+    }
+
+    bool DesktopEntry::isValid() const {
+        return m_valid;
+    }
+
+    QByteArray DesktopEntry::locale() const {
+        return m_locale;
+    }
+
+    void DesktopEntry::setLocale(const QByteArray &locale) {
+        m_locale = locale;
+    }
+
+    QByteArray DesktopEntry::systemLocale() {
+        for (const char *name : { "LC_ALL", "LC_MESSAGES", "LANG" }) {
+            const QByteArray locale = qgetenv(name);
+            if (locale.isEmpty())
+                continue;
+            if (locale == "C" || locale == "POSIX")
+                return QByteArray();
+            return locale;
+        }
+        return QByteArray();
+    }
+
+    const DesktopEntry::Item *DesktopEntry::find(const char *key, bool localized) const {
+        // lang_COUNTRY.ENCODING@MODIFIER matches, in order of preference,
+        // lang_COUNTRY@MODIFIER, lang_COUNTRY, lang@MODIFIER and lang
+        QByteArray candidates[4];
+        int count = 0;
+        if (localized && !m_locale.isEmpty()) {
+            QByteArray lang = m_locale;
+            QByteArray modifier;
+            int index = lang.indexOf('@');
+            if (index != -1) {
+                modifier = lang.mid(index);
+                lang.truncate(index);
+            }
+            index = lang.indexOf('.');
+            if (index != -1)
+                lang.truncate(index);
+            QByteArray country;
+            index = lang.indexOf('_');
+            if (index != -1) {
+                country = lang.mid(index);
+                lang.truncate(index);
+            }
+
+            if (!country.isEmpty() && !modifier.isEmpty())
+                candidates[count++] = lang + country + modifier;
+            if (!country.isEmpty())
+                candidates[count++] = lang + country;
+            if (!modifier.isEmpty())
+                candidates[count++] = lang + modifier;
+            candidates[count++] = lang;
+        }
+
+        const int keyLength = int(strlen(key));
+        const char *data = m_data.constData();
+        const Item *best = nullptr;
+        int bestRank = count + 1;
+
+        for (const Item &item : m_items) {
+            if (item.keyLength != keyLength || memcmp(data + item.key, key, keyLength) != 0)
+                continue;
+
+            int rank = count;
+            if (item.localeLength) {
+                rank = 0;
+                while (rank < count && (candidates[rank].size() != item.localeLength ||
+                                        memcmp(data + item.locale, candidates[rank].constData(), item.localeLength) != 0))
+                    ++rank;
+                if (rank == count)
+                    continue;
+            }
+
+            // the first occurrence of a key wins
+            if (rank < bestRank) {
+                best = &item;
+                bestRank = rank;
+                if (rank == 0)
+                    break;
+            }
+        }
+
+        return best;
+    }
+
+    bool DesktopEntry::contains(const char *key) const {
+        return find(key, false) != nullptr;
+    }
+
+    QString DesktopEntry::value(const char *key, const QString &defaultValue) const {
+        const Item *item = find(key, false);
+        if (!item)
+            return defaultValue;
+        const char *value = m_data.constData() + item->value;
+        return unescape(value, value + item->valueLength, false).first();
+    }
+
+    QString DesktopEntry::localizedValue(const char *key, const QString &defaultValue) const {
+        const Item *item = find(key, true);
+        if (!item)
+            return defaultValue;
+        const char *value = m_data.constData() + item->value;
+        return unescape(value, value + item->valueLength, false).first();
+    }
+
+    QStringList DesktopEntry::listValue(const char *key) const {
+        const Item *item = find(key, false);
+        if (!item)
+            return QStringList();
+        const char *value = m_data.constData() + item->value;
+        return unescape(value, value + item->valueLength, true);
+    }
+
+    bool DesktopEntry::boolValue(const char *key, bool defaultValue) const {
+        const Item *item = find(key, false);
+        if (!item)
+            return defaultValue;
+        const char *value = m_data.constData() + item->value;
+        // the specification only allows lowercase, older files use other cases
+        return item->valueLength == 4 && qstrnicmp(value, "true", 4) == 0;
+    }
+}
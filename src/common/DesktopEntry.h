@@ -0,0 +1,85 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_DESKTOPENTRY_H
+#define SDDM_DESKTOPENTRY_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QStringList>
+#include <QVector>
+
+namespace SDDM {
+    // Single pass parser for one group of a desktop entry file.
+    //
+    // The file is memory mapped and only the positions of the keys of the
+    // requested group are recorded, values are decoded when asked for.
+    // Localized keys are resolved following the locale matching rules of
+    // the Desktop Entry Specification, escape sequences are expanded and
+    // a trailing backslash continues a value on the next line.
+    class DesktopEntry {
+        Q_DISABLE_COPY(DesktopEntry)
+    public:
+        explicit DesktopEntry(const QString &group = QStringLiteral("Desktop Entry"));
+        ~DesktopEntry();
+
+        // Maps and parses the file, the mapping lives as long as this object
+        bool load(const QString &path);
+        // Parses data in place, data is shared, not copied
+        bool parse(const QByteArray &data);
+
+        bool isValid() const;
+
+        // Locale used for localized values, defaults to LC_ALL, LC_MESSAGES
+        // or LANG, in this order
+        QByteArray locale() const;
+        void setLocale(const QByteArray &locale);
+
+        bool contains(const char *key) const;
+        QString value(const char *key, const QString &defaultValue = QString()) const;
+        QString localizedValue(const char *key, const QString &defaultValue = QString()) const;
+        QStringList listValue(const char *key) const;
+        bool boolValue(const char *key, bool defaultValue = false) const;
+
+        static QByteArray systemLocale();
+
+    private:
+        struct Item {
+            int key;
+            int keyLength;
+            int locale;
+            int localeLength;
+            int value;
+            int valueLength;
+        };
+
+        void close();
+        const Item *find(const char *key, bool localized) const;
+
+        QString m_group;
+        QByteArray m_locale;
+        QByteArray m_data;
+        QFile m_file;
+        uchar *m_map { nullptr };
+        QVector<Item> m_items;
+        bool m_valid { false };
+    };
+}
+
+#endif // SDDM_DESKTOPENTRY_H
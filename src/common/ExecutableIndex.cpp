@@ -0,0 +1,120 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "ExecutableIndex.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+
+namespace SDDM {
+    // directory modification times are checked at most this often
+    static const qint64 s_checkInterval = 2000;
+
+    struct IndexedDir {
+        qint64 modified { -1 };
+        qint64 checked { 0 };
+        QSet<QString> executables;
+    };
+
+    struct Index {
+        QMutex mutex;
+        // every directory that was ever searched, $PATH and the
+        // default path of the users are usually the same few
+        QHash<QString, IndexedDir> dirs;
+    };
+
+    Q_GLOBAL_STATIC(Index, s_index)
+
+    static qint64 dirModified(const QString &path) {
+        QFileInfo info(path);
+        return info.isDir() ? info.lastModified().toMSecsSinceEpoch() : -1;
+    }
+
+    // Brings the listing of path up to date, called with the mutex locked
+    static const IndexedDir &indexed(Index *index, const QString &path, qint64 now) {
+        IndexedDir &dir = index->dirs[path];
+        if (now - dir.checked < s_checkInterval)
+            return dir;
+        dir.checked = now;
+
+        const qint64 modified = dirModified(path);
+        if (modified == dir.modified)
+            return dir;
+
+        dir.modified = modified;
+        dir.executables.clear();
+        if (modified == -1)
+            return dir;
+
+        QDirIterator it(path, QDir::Files | QDir::Executable);
+        while (it.hasNext()) {
+            it.next();
+            dir.executables.insert(it.fileName());
+        }
+        return dir;
+    }
+
+    bool ExecutableIndex::contains(const QString &program) {
+        return !find(program).isEmpty();
+    }
+
+    bool ExecutableIndex::contains(const QString &program, const QString &searchPath) {
+        return !find(program, searchPath).isEmpty();
+    }
+
+    QString ExecutableIndex::find(const QString &program) {
+        return find(program, QString::fromLocal8Bit(qgetenv("PATH")));
+    }
+
+    QString ExecutableIndex::find(const QString &program, const QString &searchPath) {
+        if (program.isEmpty())
+            return QString();
+
+        QFileInfo fi(program);
+        if (fi.isAbsolute())
+            return fi.exists() && fi.isExecutable() ? program : QString();
+
+        const QStringList dirs = searchPath.split(QLatin1Char(':'), QString::SkipEmptyParts);
+
+        // relative paths with directories can't be indexed
+        if (program.contains(QLatin1Char('/'))) {
+            for (const QString &dir : dirs) {
+                fi.setFile(QDir(dir), program);
+                if (fi.exists() && fi.isExecutable())
+                    return fi.absoluteFilePath();
+            }
+            return QString();
+        }
+
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        QMutexLocker locker(&s_index->mutex);
+        for (const QString &dir : dirs) {
+            if (indexed(s_index, dir, now).executables.contains(program))
+                return QStringLiteral("%1/%2").arg(dir).arg(program);
+        }
+
+        return QString();
+    }
+}
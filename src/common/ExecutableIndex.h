@@ -0,0 +1,45 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_EXECUTABLEINDEX_H
+#define SDDM_EXECUTABLEINDEX_H
+
+#include <QString>
+
+namespace SDDM {
+    // Process wide index of the executables found in $PATH.
+    //
+    // Each directory is listed once and listed again only when its
+    // modification time changes, so looking a program up is a hash
+    // lookup most of the time. Thread safe.
+    class ExecutableIndex {
+    public:
+        // Whether program is an executable file, either as an absolute
+        // path or found in one of the directories of $PATH
+        static bool contains(const QString &program);
+        // Same, searching the colon separated directories of searchPath
+        static bool contains(const QString &program, const QString &searchPath);
+
+        // Absolute path of program, empty if not found
+        static QString find(const QString &program);
+        static QString find(const QString &program, const QString &searchPath);
+    };
+}
+
+#endif // SDDM_EXECUTABLEINDEX_H
@@ -18,20 +18,47 @@
 * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 ***************************************************************************/
 
-#include <QFile>
 #include <QFileInfo>
-#include <QTextStream>
 
 #include "Configuration.h"
+#include "DesktopEntry.h"
 #include "Session.h"
+#include "Session_p.h"
 
 const QString s_entryExtention = QStringLiteral(".desktop");
 
 namespace SDDM {
+    void SessionPrivate::setDirectory(Session::Type type)
+    {
+        switch (type) {
+        case Session::X11Session:
+            dir = QDir(mainConfig.X11.SessionDir.get());
+            xdgSessionType = QStringLiteral("x11");
+            break;
+        case Session::WaylandSession:
+            dir = QDir(mainConfig.Wayland.SessionDir.get());
+            xdgSessionType = QStringLiteral("wayland");
+            break;
+        default:
+            xdgSessionType.clear();
+            break;
+        }
+    }
+
+    QString SessionPrivate::displayNameFor(Session::Type type, const QString &name)
+    {
+        if (type == Session::WaylandSession)
+            return QObject::tr("%1 (Wayland)").arg(name);
+        return name;
+    }
+
     Session::Session()
-        : m_valid(false)
-        , m_type(UnknownSession)
-        , m_isHidden(false)
+        : d(new SessionPrivate())
+    {
+    }
+
+    Session::Session(SessionPrivate *dd)
+        : d(dd)
     {
     }
 
@@ -41,59 +68,73 @@ namespace SDDM {
         setTo(type, fileName);
     }
 
+    Session::Session(const Session &other)
+        : d(other.d)
+    {
+    }
+
+    Session::Session(Session &&other)
+        : d(std::move(other.d))
+    {
+    }
+
+    Session::~Session()
+    {
+    }
+
     bool Session::isValid() const
     {
-        return m_valid;
+        return d->valid;
     }
 
     Session::Type Session::type() const
     {
-        return m_type;
+        return d->type;
     }
 
     int Session::vt() const
     {
-        return m_vt;
+        return d->vt;
     }
 
     void Session::setVt(int vt)
     {
-        m_vt = vt;
+        d->vt = vt;
     }
 
     QString Session::xdgSessionType() const
     {
-        return m_xdgSessionType;
+        return d->xdgSessionType;
     }
 
     QDir Session::directory() const
     {
-        return m_dir;
+        return d->dir;
     }
 
     QString Session::fileName() const
     {
-        return m_fileName;
+        return d->fileName;
     }
 
     QString Session::displayName() const
     {
-        return m_displayName;
+        return d->displayName;
     }
 
     QString Session::comment() const
     {
-        return m_comment;
+        return d->comment;
     }
 
     QString Session::exec() const
     {
-        return m_exec;
+        return d->exec;
     }
 
     QString Session::tryExec() const
     {
-        return m_tryExec;
+        return d->tryExec;
     }
 
     QString Session::desktopSession() const
@@ -103,12 +144,17 @@ namespace SDDM {
 
     QString Session::desktopNames() const
     {
-        return m_desktopNames;
+        return d->desktopNames;
     }
 
     bool Session::isHidden() const
     {
-        return m_isHidden;
+        return d->isHidden;
+    }
+
+    bool Session::isNoDisplay() const
+    {
+        return d->isNoDisplay;
     }
 
     void Session::setTo(Type type, const QString &_fileName)
@@ -119,75 +165,42 @@ namespace SDDM {
 
         QFileInfo info(fileName);
 
-        m_type = UnknownSession;
-        m_valid = false;
-        m_desktopNames.clear();
+        // Start from a fresh private so copies of the old value keep theirs
+        const int vt = d->vt;
+        d = new SessionPrivate();
+        d->vt = vt;
 
-        switch (type) {
-        case X11Session:
-            m_dir = QDir(mainConfig.X11.SessionDir.get());
-            m_xdgSessionType = QStringLiteral("x11");
-            break;
-        case WaylandSession:
-            m_dir = QDir(mainConfig.Wayland.SessionDir.get());
-            m_xdgSessionType = QStringLiteral("wayland");
-            break;
-        default:
-            m_xdgSessionType.clear();
-            break;
-        }
+        d->setDirectory(type);
 
-        m_fileName = m_dir.absoluteFilePath(fileName);
+        d->fileName = d->dir.absoluteFilePath(fileName);
 
-        qDebug() << "Reading from" << m_fileName;
+        qDebug() << "Reading from" << d->fileName;
 
-        QFile file(m_fileName);
-        if (!file.open(QIODevice::ReadOnly))
+        DesktopEntry entry;
+        if (!entry.load(d->fileName))
             return;
 
-        QString current_section;
-
-        QTextStream in(&file);
-        while (!in.atEnd()) {
-            QString line = in.readLine();
-
-            if (line.startsWith(QLatin1String("["))) {
-                // The section name ends before the last ] before the start of a comment
-                int end = line.lastIndexOf(QLatin1Char(']'), line.indexOf(QLatin1Char('#')));
-                if (end != -1)
-                    current_section = line.mid(1, end - 1);
-            }
-
-            if (current_section != QLatin1String("Desktop Entry"))
-                continue; // We are only interested in the "Desktop Entry" section
-
-            if (line.startsWith(QLatin1String("Name="))) {
-                if (type == WaylandSession)
-                    m_displayName = QObject::tr("%1 (Wayland)").arg(line.mid(5));
-                else
-                    m_displayName = line.mid(5);
-            }
-            if (line.startsWith(QLatin1String("Comment=")))
-                m_comment = line.mid(8);
-            if (line.startsWith(QLatin1String("Exec=")))
-                m_exec = line.mid(5);
-            if (line.startsWith(QStringLiteral("TryExec=")))
-                m_tryExec = line.mid(8);
-            if (line.startsWith(QLatin1String("DesktopNames=")))
-                m_desktopNames = line.mid(13).replace(QLatin1Char(';'), QLatin1Char(':'));
-            if (line.startsWith(QLatin1String("Hidden=")))
-                m_isHidden = line.mid(7).toLower() == QLatin1String("true");
-        }
-
-        file.close();
+        d->displayName = SessionPrivate::displayNameFor(type, entry.localizedValue("Name"));
+        d->comment = entry.localizedValue("Comment");
+        d->exec = entry.value("Exec");
+        d->tryExec = entry.value("TryExec");
+        d->desktopNames = entry.listValue("DesktopNames").join(QLatin1Char(':'));
+        d->isHidden = entry.boolValue("Hidden");
+        d->isNoDisplay = entry.boolValue("NoDisplay");
 
-        m_type = type;
-        m_valid = true;
+        d->type = type;
+        d->valid = true;
     }
 
     Session &Session::operator=(const Session &other)
     {
-        setTo(other.type(), other.fileName());
+        d = other.d;
+        return *this;
+    }
+
+    Session &Session::operator=(Session &&other)
+    {
+        d = std::move(other.d);
         return *this;
     }
 }
@@ -22,11 +22,14 @@
 
 #include <QDataStream>
 #include <QDir>
-#include <QSharedPointer>
+#include <QSharedDataPointer>
 
 namespace SDDM {
+    class SessionCatalog;
     class SessionModel;
+    class SessionPrivate;
 
+    // Implicitly shared, copies don't touch the desktop file
     class Session {
     public:
         enum Type {
@@ -37,6 +40,9 @@ namespace SDDM {
 
         explicit Session();
         Session(Type type, const QString &fileName);
+        Session(const Session &other);
+        Session(Session &&other);
+        ~Session();
 
         bool isValid() const;
 
@@ -60,26 +66,20 @@ namespace SDDM {
         QString desktopNames() const;
 
         bool isHidden() const;
+        bool isNoDisplay() const;
 
+        // Reads the desktop file, the only place where it happens
         void setTo(Type type, const QString &name);
 
         Session &operator=(const Session &other);
+        Session &operator=(Session &&other);
 
     private:
-        bool m_valid;
-        Type m_type;
-        int m_vt;
-        QDir m_dir;
-        QString m_name;
-        QString m_fileName;
-        QString m_displayName;
-        QString m_comment;
-        QString m_exec;
-        QString m_tryExec;
-        QString m_xdgSessionType;
-        QString m_desktopNames;
-        bool m_isHidden;
+        explicit Session(SessionPrivate *dd);
 
+        QSharedDataPointer<SessionPrivate> d;
+
+        friend class SessionCatalog;
         friend class SessionModel;
     };
 
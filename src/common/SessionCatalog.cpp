@@ -0,0 +1,395 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "SessionCatalog.h"
+
+#include "Configuration.h"
+#include "Constants.h"
+#include "DesktopEntry.h"
+#include "ExecutableIndex.h"
+#include "Session_p.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QVector>
+
+#include <algorithm>
+#include <string.h>
+
+namespace SDDM {
+    static const char s_magic[8] = { 'S', 'D', 'D', 'M', 'S', 'E', 'S', '\0' };
+    static const quint32 s_version = 1;
+
+    struct StringRef {
+        quint32 offset;
+        quint32 length;
+    };
+
+    struct CatalogHeader {
+        char magic[8];
+        quint32 version;
+        quint32 count;
+        // source directories and their modification times
+        quint64 sourceStamp;
+        quint64 fingerprint;
+        // size of the string pool in UTF-16 code units
+        quint32 stringsSize;
+        quint32 reserved;
+    };
+
+    struct CatalogRecord {
+        quint32 type;
+        quint32 flags;
+        qint64 modified;
+        StringRef fileName;
+        StringRef name;
+        StringRef comment;
+        StringRef exec;
+        StringRef tryExec;
+        StringRef desktopNames;
+    };
+
+    // The file is made of the header followed by
+    //   CatalogRecord records[count]
+    //   QChar strings[stringsSize]
+    static qint64 expectedSize(quint32 count, quint32 stringsSize) {
+        return qint64(sizeof(CatalogHeader)) + qint64(count) * sizeof(CatalogRecord)
+                + qint64(stringsSize) * sizeof(QChar);
+    }
+
+    static QString sessionDir(Session::Type type) {
+        return type == Session::WaylandSession ? mainConfig.Wayland.SessionDir.get() : mainConfig.X11.SessionDir.get();
+    }
+
+    static quint64 toStamp(const QByteArray &hash) {
+        quint64 stamp = 0;
+        memcpy(&stamp, hash.constData(), sizeof(stamp));
+        return stamp;
+    }
+
+    // Hash of the source directories and their modification times, a few
+    // stat calls no matter how many sessions there are
+    static quint64 sourceStamp() {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        for (const QString &path : SessionCatalog::sourceDirectories()) {
+            QFileInfo info(path);
+            const qint64 modified = info.isDir() ? info.lastModified().toMSecsSinceEpoch() : -1;
+            hash.addData(path.toUtf8());
+            hash.addData(reinterpret_cast<const char *>(&modified), sizeof(modified));
+        }
+        return toStamp(hash.result());
+    }
+
+    // Hash of all the settings that affect the content of the catalog
+    static quint64 configFingerprint() {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(mainConfig.X11.SessionDir.get().toUtf8());
+        hash.addData(mainConfig.Wayland.SessionDir.get().toUtf8());
+        hash.addData(mainConfig.Users.DefaultPath.get().toUtf8());
+        // names and comments are localized
+        hash.addData(DesktopEntry::systemLocale());
+        return toStamp(hash.result());
+    }
+
+    class SessionCatalogPrivate {
+    public:
+        QFile file;
+        uchar *data { nullptr };
+        const CatalogHeader *header { nullptr };
+        const CatalogRecord *records { nullptr };
+        const QChar *strings { nullptr };
+
+        const CatalogRecord *record(int row) const {
+            if (!header || row < 0 || quint32(row) >= header->count)
+                return nullptr;
+            return records + row;
+        }
+
+        QString string(const StringRef &ref) const {
+            if (quint64(ref.offset) + ref.length > header->stringsSize)
+                return QString();
+            return QString(strings + ref.offset, int(ref.length));
+        }
+
+        bool equals(const StringRef &ref, const QString &str) const {
+            return quint64(ref.offset) + ref.length <= header->stringsSize && int(ref.length) == str.size() &&
+                    memcmp(strings + ref.offset, str.constData(), ref.length * sizeof(QChar)) == 0;
+        }
+    };
+
+    SessionCatalog::SessionCatalog() : d(new SessionCatalogPrivate()) {
+    }
+
+    SessionCatalog::~SessionCatalog() {
+        close();
+        delete d;
+    }
+
+    QString SessionCatalog::defaultPath() {
+        return QStringLiteral(RUNTIME_DIR "/sessions.cache");
+    }
+
+    QStringList SessionCatalog::sourceDirectories() {
+        QStringList dirs;
+        dirs << mainConfig.X11.SessionDir.get() << mainConfig.Wayland.SessionDir.get();
+        // installing or removing a program changes TryExec verdicts
+        dirs << mainConfig.Users.DefaultPath.get().split(QLatin1Char(':'), QString::SkipEmptyParts);
+        return dirs;
+    }
+
+    bool SessionCatalog::write(const QString &path) {
+        struct SessionFile {
+            Session::Type type;
+            QFileInfo info;
+        };
+
+        // stamp the catalog before reading, a change made meanwhile will
+        // make it stale rather than go unnoticed
+        CatalogHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, s_magic, sizeof(header.magic));
+        header.version = s_version;
+        header.sourceStamp = sourceStamp();
+        header.fingerprint = configFingerprint();
+
+        QVector<SessionFile> files;
+        for (Session::Type type : { Session::X11Session, Session::WaylandSession }) {
+            QDir dir(sessionDir(type));
+            for (const QFileInfo &info : dir.entryInfoList(QStringList() << QStringLiteral("*.desktop"), QDir::Files))
+                files << SessionFile { type, info };
+        }
+
+        // same order as the session model
+        std::sort(files.begin(), files.end(), [](const SessionFile &f1, const SessionFile &f2) {
+            if (f1.type != f2.type)
+                return f1.type < f2.type;
+            return QString::compare(f1.info.fileName(), f2.info.fileName(), Qt::CaseInsensitive) < 0;
+        });
+
+        QVector<CatalogRecord> records;
+        QString strings;
+        auto addString = [&strings](const QString &str) {
+            StringRef ref;
+            ref.offset = quint32(strings.size());
+            ref.length = quint32(str.size());
+            strings.append(str);
+            return ref;
+        };
+
+        const QString defaultPath = mainConfig.Users.DefaultPath.get();
+        for (const SessionFile &file : files) {
+            DesktopEntry entry;
+            if (!entry.load(file.info.filePath()))
+                continue;
+
+            CatalogRecord record;
+            memset(&record, 0, sizeof(record));
+            record.type = quint32(file.type);
+            record.modified = file.info.lastModified().toMSecsSinceEpoch();
+
+            const QString tryExec = entry.value("TryExec");
+            if (entry.boolValue("Hidden"))
+                record.flags |= HiddenFlag;
+            if (entry.boolValue("NoDisplay"))
+                record.flags |= NoDisplayFlag;
+            if (tryExec.isEmpty() || ExecutableIndex::contains(tryExec, defaultPath))
+                record.flags |= ExecAllowedFlag;
+
+            record.fileName = addString(file.info.fileName());
+            record.name = addString(entry.localizedValue("Name"));
+            record.comment = addString(entry.localizedValue("Comment"));
+            record.exec = addString(entry.value("Exec"));
+            record.tryExec = addString(tryExec);
+            record.desktopNames = addString(entry.listValue("DesktopNames").join(QLatin1Char(':')));
+            records << record;
+        }
+
+        header.count = quint32(records.size());
+        header.stringsSize = quint32(strings.size());
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Failed to write session catalog" << path << file.errorString();
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(records.constData()), records.size() * sizeof(CatalogRecord));
+        file.write(reinterpret_cast<const char *>(strings.constData()), strings.size() * sizeof(QChar));
+
+        // greeters run as an unprivileged user
+        file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner |
+                            QFileDevice::ReadGroup | QFileDevice::ReadOther);
+
+        if (!file.commit()) {
+            qWarning() << "Failed to write session catalog" << path << file.errorString();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SessionCatalog::open(const QString &path) {
+        close();
+
+        d->file.setFileName(path);
+        if (!d->file.open(QIODevice::ReadOnly))
+            return false;
+
+        const qint64 size = d->file.size();
+        if (size < qint64(sizeof(CatalogHeader))) {
+            close();
+            return false;
+        }
+
+        d->data = d->file.map(0, size);
+        if (!d->data) {
+            close();
+            return false;
+        }
+
+        const CatalogHeader *header = reinterpret_cast<const CatalogHeader *>(d->data);
+        if (memcmp(header->magic, s_magic, sizeof(s_magic)) != 0 || header->version != s_version ||
+                expectedSize(header->count, header->stringsSize) != size) {
+            qWarning() << "Ignoring corrupted session catalog" << path;
+            close();
+            return false;
+        }
+
+        d->header = header;
+        d->records = reinterpret_cast<const CatalogRecord *>(d->data + sizeof(CatalogHeader));
+        d->strings = reinterpret_cast<const QChar *>(d->records + header->count);
+
+        if (!isCurrent()) {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void SessionCatalog::close() {
+        d->header = nullptr;
+        d->records = nullptr;
+        d->strings = nullptr;
+        if (d->data) {
+            d->file.unmap(d->data);
+            d->data = nullptr;
+        }
+        d->file.close();
+    }
+
+    bool SessionCatalog::isOpen() const {
+        return d->header != nullptr;
+    }
+
+    bool SessionCatalog::isCurrent() const {
+        return d->header && d->header->fingerprint == configFingerprint() &&
+                d->header->sourceStamp == sourceStamp();
+    }
+
+    bool SessionCatalog::isCurrent(int row) const {
+        const CatalogRecord *record = d->record(row);
+        if (!record)
+            return false;
+
+        const Session::Type type = static_cast<Session::Type>(record->type);
+        const QFileInfo info(QDir(sessionDir(type)).absoluteFilePath(d->string(record->fileName)));
+        return info.exists() && info.lastModified().toMSecsSinceEpoch() == record->modified;
+    }
+
+    int SessionCatalog::count() const {
+        return d->header ? int(d->header->count) : 0;
+    }
+
+    Session::Type SessionCatalog::type(int row) const {
+        const CatalogRecord *record = d->record(row);
+        return record ? static_cast<Session::Type>(record->type) : Session::UnknownSession;
+    }
+
+    QString SessionCatalog::fileName(int row) const {
+        const CatalogRecord *record = d->record(row);
+        return record ? d->string(record->fileName) : QString();
+    }
+
+    qint64 SessionCatalog::modified(int row) const {
+        const CatalogRecord *record = d->record(row);
+        return record ? record->modified : -1;
+    }
+
+    int SessionCatalog::flags(int row) const {
+        const CatalogRecord *record = d->record(row);
+        return record ? int(record->flags) : 0;
+    }
+
+    Session SessionCatalog::session(int row) const {
+        const CatalogRecord *record = d->record(row);
+        if (!record)
+            return Session();
+
+        const Session::Type type = static_cast<Session::Type>(record->type);
+
+        SessionPrivate *session = new SessionPrivate();
+        session->setDirectory(type);
+        session->type = type;
+        session->fileName = session->dir.absoluteFilePath(d->string(record->fileName));
+        session->displayName = SessionPrivate::displayNameFor(type, d->string(record->name));
+        session->comment = d->string(record->comment);
+        session->exec = d->string(record->exec);
+        session->tryExec = d->string(record->tryExec);
+        session->desktopNames = d->string(record->desktopNames);
+        session->isHidden = record->flags & HiddenFlag;
+        session->isNoDisplay = record->flags & NoDisplayFlag;
+        session->valid = true;
+
+        return Session(session);
+    }
+
+    int SessionCatalog::indexOf(Session::Type type, const QString &name) const {
+        if (!d->header || name.isEmpty())
+            return -1;
+
+        // only files right in the session directory are in the catalog
+        QFileInfo info(name);
+        if (info.isAbsolute()) {
+            if (QDir::cleanPath(info.absolutePath()) != QDir::cleanPath(sessionDir(type)))
+                return -1;
+        } else if (name.contains(QLatin1Char('/'))) {
+            return -1;
+        }
+
+        QString fileName = info.fileName();
+        if (!fileName.endsWith(QLatin1String(".desktop")))
+            fileName += QLatin1String(".desktop");
+
+        // there are only a handful of sessions
+        for (quint32 row = 0; row < d->header->count; ++row) {
+            const CatalogRecord &record = d->records[row];
+            if (record.type == quint32(type) && d->equals(record.fileName, fileName))
+                return int(row);
+        }
+
+        return -1;
+    }
+}
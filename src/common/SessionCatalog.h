@@ -0,0 +1,87 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_SESSIONCATALOG_H
+#define SDDM_SESSIONCATALOG_H
+
+#include "Session.h"
+
+#include <QStringList>
+
+namespace SDDM {
+    class SessionCatalogPrivate;
+
+    // Binary catalog of the parsed X11 and Wayland session files along
+    // with their TryExec verdicts. Written by the daemon and memory mapped
+    // read-only by the daemon and the greeters, so that neither of them
+    // has to parse the session files again.
+    class SessionCatalog {
+        Q_DISABLE_COPY(SessionCatalog)
+    public:
+        enum Flag {
+            HiddenFlag = 0x1,
+            NoDisplayFlag = 0x2,
+            // TryExec is empty or installed in the default $PATH of the users
+            ExecAllowedFlag = 0x4
+        };
+
+        SessionCatalog();
+        ~SessionCatalog();
+
+        static QString defaultPath();
+        // Directories the catalog is invalidated by, the session
+        // directories and those of the default $PATH of the users
+        static QStringList sourceDirectories();
+
+        // Parses every session file and writes the catalog to path,
+        // replacing it atomically
+        static bool write(const QString &path);
+
+        // Maps the catalog at path, fails if the file is missing, corrupted
+        // or stale with respect to the source directories and the
+        // current configuration
+        bool open(const QString &path);
+        void close();
+        bool isOpen() const;
+        // Whether the mapped catalog still matches the source directories
+        bool isCurrent() const;
+        // Whether the file of the session at row is unchanged, editing a
+        // file in place doesn't touch its directory
+        bool isCurrent(int row) const;
+
+        // Sessions are sorted by type and file name
+        int count() const;
+        Session::Type type(int row) const;
+        // File name without the directory
+        QString fileName(int row) const;
+        // Modification time in milliseconds since epoch
+        qint64 modified(int row) const;
+        int flags(int row) const;
+        Session session(int row) const;
+
+        // Row of the session file called name, with or without the
+        // extension or as an absolute path, -1 if there is no such session
+        int indexOf(Session::Type type, const QString &name) const;
+
+    private:
+        SessionCatalogPrivate *d { nullptr };
+    };
+}
+
+#endif // SDDM_SESSIONCATALOG_H
@@ -0,0 +1,50 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_SESSION_P_H
+#define SDDM_SESSION_P_H
+
+#include "Session.h"
+
+namespace SDDM {
+    class SessionPrivate : public QSharedData {
+    public:
+        // Directory and XDG session type of sessions of the given type
+        void setDirectory(Session::Type type);
+
+        // Name shown for a session whose desktop file is called name
+        static QString displayNameFor(Session::Type type, const QString &name);
+
+        bool valid { false };
+        Session::Type type { Session::UnknownSession };
+        int vt { 0 };
+        QDir dir;
+        QString fileName;
+        QString displayName;
+        QString comment;
+        QString exec;
+        QString tryExec;
+        QString xdgSessionType;
+        QString desktopNames;
+        bool isHidden { false };
+        bool isNoDisplay { false };
+    };
+}
+
+#endif // SDDM_SESSION_P_H
@@ -0,0 +1,103 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "StatCache.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+
+#include <sys/stat.h>
+
+namespace SDDM {
+    // results younger than this many milliseconds are used without
+    // touching the file system
+    static const qint64 s_trustInterval = 5 * 1000;
+
+    struct StatEntry {
+        // -1 if the file doesn't exist
+        qint64 modified;
+        // modification time of the parent directory when the file was missing
+        qint64 dirModified;
+        qint64 checked;
+    };
+
+    static QMutex s_mutex;
+    static QHash<QString, StatEntry> s_entries;
+
+    static qint64 statModified(const QString &path) {
+        struct stat st;
+        if (::stat(QFile::encodeName(path).constData(), &st) != 0)
+            return -1;
+        return qint64(st.st_mtim.tv_sec) * 1000 + st.st_mtim.tv_nsec / 1000000;
+    }
+
+    static QString parentDir(const QString &path) {
+        const int slash = path.lastIndexOf(QLatin1Char('/'));
+        return slash > 0 ? path.left(slash) : QStringLiteral("/");
+    }
+
+    qint64 StatCache::modified(const QString &path) {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+        StatEntry entry { -1, -1, 0 };
+        bool cached = false;
+        {
+            QMutexLocker locker(&s_mutex);
+            auto it = s_entries.constFind(path);
+            if (it != s_entries.constEnd()) {
+                entry = it.value();
+                cached = true;
+            }
+        }
+
+        // stat outside of the lock, it can block on network file systems
+        if (cached && now - entry.checked < s_trustInterval)
+            return entry.modified;
+
+        bool changed = true;
+        if (cached && entry.modified == -1) {
+            // nothing was created or renamed next to the missing file
+            const qint64 dirModified = statModified(parentDir(path));
+            changed = dirModified == -1 || dirModified != entry.dirModified;
+            entry.dirModified = dirModified;
+        }
+
+        if (changed) {
+            entry.modified = statModified(path);
+            entry.dirModified = entry.modified == -1 ? statModified(parentDir(path)) : -1;
+        }
+        entry.checked = now;
+
+        QMutexLocker locker(&s_mutex);
+        s_entries.insert(path, entry);
+        return entry.modified;
+    }
+
+    void StatCache::invalidate(const QString &path) {
+        QMutexLocker locker(&s_mutex);
+        s_entries.remove(path);
+    }
+
+    void StatCache::clear() {
+        QMutexLocker locker(&s_mutex);
+        s_entries.clear();
+    }
+}
@@ -0,0 +1,48 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_STATCACHE_H
+#define SDDM_STATCACHE_H
+
+#include <QString>
+
+namespace SDDM {
+    // Process wide, thread safe cache of stat(2) results.
+    //
+    // Results are trusted for 5 seconds, a new or replaced file can go
+    // unnoticed for that long. After that a missing file is
+    // revalidated by looking at the modification time of its directory,
+    // which is shared by many lookups, and an existing file by its own
+    // modification time.
+    class StatCache {
+    public:
+        // Modification time of path in milliseconds since epoch,
+        // -1 if it doesn't exist
+        static qint64 modified(const QString &path);
+
+        static bool exists(const QString &path) {
+            return modified(path) != -1;
+        }
+
+        static void invalidate(const QString &path);
+        static void clear();
+    };
+}
+
+#endif // SDDM_STATCACHE_H
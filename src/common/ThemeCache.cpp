@@ -0,0 +1,134 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "ThemeCache.h"
+
+#include "Constants.h"
+#include "ThemeConfig.h"
+#include "ThemeMetadata.h"
+#include "ThemeMetadata_p.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QVector>
+
+namespace SDDM {
+    static const quint32 s_magic = 0x53445448; // "SDTH"
+    static const quint32 s_version = 1;
+
+    struct ThemeSource {
+        QString path;
+        qint64 modified;
+    };
+
+    static qint64 modifiedTime(const QString &path) {
+        const QDateTime modified = QFileInfo(path).lastModified();
+        return modified.isValid() ? modified.toMSecsSinceEpoch() : -1;
+    }
+
+    // the files the metadata and the configuration are read from
+    static QVector<ThemeSource> sources(const QString &themePath, const QString &configFile) {
+        QVector<ThemeSource> result;
+        for (const QString &path : { QStringLiteral("%1/metadata.desktop").arg(themePath),
+                                     QStringLiteral("%1/%2").arg(themePath).arg(configFile),
+                                     QStringLiteral("%1/%2.user").arg(themePath).arg(configFile) })
+            result.append({ path, modifiedTime(path) });
+        return result;
+    }
+
+    QString ThemeCache::path(const QString &themePath) {
+        const QByteArray hash = QCryptographicHash::hash(themePath.toUtf8(), QCryptographicHash::Sha1).toHex();
+        return QStringLiteral("%1/theme-%2.cache").arg(QStringLiteral(RUNTIME_DIR)).arg(QString::fromLatin1(hash.left(16)));
+    }
+
+    bool ThemeCache::read(const QString &cachePath, const QString &themePath,
+                          ThemeMetadata *metadata, ThemeConfig *config) {
+        QFile file(cachePath);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+
+        QDataStream in(&file);
+        in.setVersion(QDataStream::Qt_5_6);
+
+        quint32 magic = 0, version = 0;
+        QString path;
+        in >> magic >> version >> path;
+        if (magic != s_magic || version != s_version || path != themePath)
+            return false;
+
+        ThemeMetadataPrivate values;
+        in >> values.mainScript >> values.configFile >> values.translationsDirectory;
+
+        // a few stat calls instead of parsing the files
+        const QVector<ThemeSource> current = sources(themePath, values.configFile);
+        for (const ThemeSource &source : current) {
+            qint64 modified = 0;
+            in >> modified;
+            if (modified != source.modified)
+                return false;
+        }
+
+        QVariantMap map;
+        in >> map;
+        if (in.status() != QDataStream::Ok)
+            return false;
+
+        *metadata->d = values;
+        config->swap(map);
+
+        qDebug() << "Theme" << themePath << "read from" << cachePath;
+        return true;
+    }
+
+    bool ThemeCache::write(const QString &cachePath, const QString &themePath,
+                           const ThemeMetadata *metadata, const ThemeConfig *config) {
+        QDir().mkpath(QFileInfo(cachePath).path());
+
+        QSaveFile file(cachePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Failed to write the theme cache" << cachePath << file.errorString();
+            return false;
+        }
+
+        QDataStream out(&file);
+        out.setVersion(QDataStream::Qt_5_6);
+
+        out << s_magic << s_version << themePath;
+        out << metadata->mainScript() << metadata->configFile() << metadata->translationsDirectory();
+        for (const ThemeSource &source : sources(themePath, metadata->configFile()))
+            out << source.modified;
+        out << static_cast<const QVariantMap &>(*config);
+
+        // the greeter runs as an unprivileged user
+        file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner |
+                            QFileDevice::ReadGroup | QFileDevice::ReadOther);
+
+        if (!file.commit()) {
+            qWarning() << "Failed to write the theme cache" << cachePath << file.errorString();
+            return false;
+        }
+
+        return true;
+    }
+}
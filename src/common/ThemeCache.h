@@ -0,0 +1,46 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_THEMECACHE_H
+#define SDDM_THEMECACHE_H
+
+#include <QString>
+
+namespace SDDM {
+    class ThemeConfig;
+    class ThemeMetadata;
+
+    // Parsed metadata and configuration of a theme, written by the daemon
+    // so that the greeter doesn't parse the same files again. The cache is
+    // only used as long as none of the files it was made from changed.
+    class ThemeCache {
+    public:
+        // Where the daemon keeps the cache of a theme
+        static QString path(const QString &themePath);
+
+        // Fills metadata and config from the cache, returns false if it's
+        // missing, made for another theme or stale
+        static bool read(const QString &cachePath, const QString &themePath,
+                         ThemeMetadata *metadata, ThemeConfig *config);
+        static bool write(const QString &cachePath, const QString &themePath,
+                          const ThemeMetadata *metadata, const ThemeConfig *config);
+    };
+}
+
+#endif // SDDM_THEMECACHE_H
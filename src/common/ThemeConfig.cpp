@@ -33,6 +33,9 @@ namespace SDDM {
     void ThemeConfig::setTo(const QString &path) {
         clear();
 
+        if (path.isEmpty())
+            return;
+
         qDebug() << "Loading theme configuration from" << path;
 
         QSettings settings(path, QSettings::IniFormat);
@@ -19,17 +19,11 @@
 ***************************************************************************/
 
 #include "ThemeMetadata.h"
+#include "ThemeMetadata_p.h"
 
-#include <QSettings>
+#include "DesktopEntry.h"
 
 namespace SDDM {
-    class ThemeMetadataPrivate {
-    public:
-        QString mainScript { QStringLiteral("Main.qml") };
-        QString configFile;
-        QString translationsDirectory { QStringLiteral(".") };
-    };
-
     ThemeMetadata::ThemeMetadata(const QString &path, QObject *parent) : QObject(parent), d(new ThemeMetadataPrivate()) {
        setTo(path);
     }
@@ -51,10 +45,11 @@ namespace SDDM {
     }
 
     void ThemeMetadata::setTo(const QString &path) {
-        QSettings settings(path, QSettings::IniFormat);
+        DesktopEntry entry(QStringLiteral("SddmGreeterTheme"));
+        entry.load(path);
         // read values
-        d->mainScript = settings.value(QStringLiteral("SddmGreeterTheme/MainScript"), QStringLiteral("Main.qml")).toString();
-        d->configFile = settings.value(QStringLiteral("SddmGreeterTheme/ConfigFile"), QStringLiteral("theme.conf")).toString();
-        d->translationsDirectory = settings.value(QStringLiteral("SddmGreeterTheme/TranslationsDirectory"), QStringLiteral(".")).toString();
+        d->mainScript = entry.value("MainScript", QStringLiteral("Main.qml"));
+        d->configFile = entry.value("ConfigFile", QStringLiteral("theme.conf"));
+        d->translationsDirectory = entry.value("TranslationsDirectory", QStringLiteral("."));
     }
 }
@@ -40,6 +40,7 @@ namespace SDDM {
         void setTo(const QString &path);
 
     private:
+        friend class ThemeCache;
         ThemeMetadataPrivate *d { nullptr };
     };
 }
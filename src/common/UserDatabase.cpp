@@ -0,0 +1,109 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "UserDatabase.h"
+
+#include "Configuration.h"
+#include "StatCache.h"
+#include "UserFilter.h"
+
+#include <QSet>
+#include <QStringList>
+
+#include <pwd.h>
+#include <string.h>
+
+namespace SDDM {
+    // Applies the [Users] filters to the entries returned by next
+    static void enumerateEntries(const UserFilter &filter, const std::function<struct passwd *()> &next,
+                                 const std::function<bool(const UserRecord &)> &visitor) {
+        // Note: getpwent() makes no attempt to suppress duplicate information
+        // if multiple sources are specified in nsswitch.conf(5).
+        QSet<uid_t> seen;
+
+        struct passwd *current_pw;
+        while ((current_pw = next()) != nullptr) {
+            // skip entries hidden by the configuration
+            if (!filter.accepts(current_pw))
+                continue;
+
+            // skip duplicates
+            if (seen.contains(current_pw->pw_uid))
+                continue;
+            seen.insert(current_pw->pw_uid);
+
+            UserRecord user;
+            user.name = QString::fromLocal8Bit(current_pw->pw_name);
+            user.realName = QString::fromLocal8Bit(current_pw->pw_gecos).split(QLatin1Char(',')).first();
+            user.homeDir = QString::fromLocal8Bit(current_pw->pw_dir);
+            user.uid = int(current_pw->pw_uid);
+            user.gid = int(current_pw->pw_gid);
+            // if shadow is used pw_passwd will be 'x' nevertheless, so this
+            // will always be true
+            user.needsPassword = strcmp(current_pw->pw_passwd, "") != 0;
+
+            if (!visitor(user))
+                break;
+        }
+    }
+
+    void UserDatabase::enumerate(const std::function<bool(const UserRecord &)> &visitor) {
+        const UserFilter filter;
+        enumerate(filter, visitor);
+    }
+
+    void UserDatabase::enumerate(const UserFilter &filter, const std::function<bool(const UserRecord &)> &visitor) {
+        setpwent();
+        enumerateEntries(filter, getpwent, visitor);
+        endpwent();
+    }
+
+    void UserDatabase::enumerate(FILE *passwd, const std::function<bool(const UserRecord &)> &visitor) {
+        const UserFilter filter;
+        enumerateEntries(filter, [passwd]() { return fgetpwent(passwd); }, visitor);
+    }
+
+    bool UserDatabase::avatarsEnabled(int userCount) {
+        bool avatarsEnabled = mainConfig.Theme.EnableAvatars.get();
+        // avatars are resolved lazily, the threshold only applies when set explicitly
+        if (avatarsEnabled && mainConfig.Theme.EnableAvatars.isDefault() && !mainConfig.Theme.DisableAvatarsThreshold.isDefault()) {
+            if (userCount > mainConfig.Theme.DisableAvatarsThreshold.get()) avatarsEnabled=false;
+        }
+        return avatarsEnabled;
+    }
+
+    QString UserDatabase::defaultFace() {
+        return QStringLiteral("file://%1/.face.icon").arg(mainConfig.Theme.FacesDir.get());
+    }
+
+    QString UserDatabase::findFace(const QString &name, const QString &homeDir, const QString &facesDir) {
+        const QString userFace = QStringLiteral("%1/.face.icon").arg(homeDir);
+        const QString systemFace = QStringLiteral("%1/%2.face.icon").arg(facesDir).arg(name);
+        QString accountsServiceFace = QStringLiteral("/var/lib/AccountsService/icons/%1").arg(name);
+
+        if (StatCache::exists(userFace))
+            return QStringLiteral("file://%1").arg(userFace);
+        else if (StatCache::exists(accountsServiceFace))
+            return accountsServiceFace;
+        else if (StatCache::exists(systemFace))
+            return QStringLiteral("file://%1").arg(systemFace);
+
+        return QString();
+    }
+}
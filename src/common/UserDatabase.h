@@ -0,0 +1,67 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERDATABASE_H
+#define SDDM_USERDATABASE_H
+
+#include <QString>
+
+#include <functional>
+
+#include <stdio.h>
+
+namespace SDDM {
+    class UserFilter;
+
+    class UserRecord {
+    public:
+        QString name;
+        QString realName;
+        QString homeDir;
+        QString icon;
+        bool needsPassword { false };
+        int uid { 0 };
+        int gid { 0 };
+    };
+
+    struct UserDatabase {
+        // Walks the passwd database and calls visitor for every user that
+        // passes the filters of the [Users] section, duplicates reported by
+        // multiple NSS sources are skipped. Enumeration stops as soon as the
+        // visitor returns false.
+        static void enumerate(const std::function<bool(const UserRecord &)> &visitor);
+        // Same as above with a filter made beforehand
+        static void enumerate(const UserFilter &filter, const std::function<bool(const UserRecord &)> &visitor);
+        // Same as above, reading the entries from a file in passwd(5) format
+        static void enumerate(FILE *passwd, const std::function<bool(const UserRecord &)> &visitor);
+
+        // Whether custom avatars should be looked up for userCount users
+        static bool avatarsEnabled(int userCount);
+
+        static QString defaultFace();
+        // Looks for the avatar of the given user in its home, in
+        // AccountsService and in facesDir, returns an empty string if the
+        // user doesn't have any. Can block on network file systems, results
+        // are cached by StatCache. Doesn't read the configuration, so it
+        // can run on any thread.
+        static QString findFace(const QString &name, const QString &homeDir, const QString &facesDir);
+    };
+}
+
+#endif // SDDM_USERDATABASE_H
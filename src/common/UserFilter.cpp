@@ -0,0 +1,213 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "UserFilter.h"
+
+#include "Configuration.h"
+
+#include <QDebug>
+#include <QHash>
+
+#include <errno.h>
+#include <fnmatch.h>
+#include <grp.h>
+#include <pwd.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace SDDM {
+    void ByteStringSet::insert(const QByteArray &str) {
+        if (contains(str.constData()))
+            return;
+
+        // keep the table at most half full
+        if ((m_entries.size() + 1) * 2 > m_slots.size())
+            rehash(qMax(16, m_slots.size() * 2));
+
+        m_entries.append(str);
+
+        const uint mask = uint(m_slots.size()) - 1;
+        uint i = qHashBits(str.constData(), size_t(str.size())) & mask;
+        while (m_slots.at(int(i)) != 0)
+            i = (i + 1) & mask;
+        m_slots[int(i)] = m_entries.size();
+    }
+
+    bool ByteStringSet::contains(const char *str) const {
+        if (m_entries.isEmpty() || !str)
+            return false;
+
+        const size_t length = strlen(str);
+        const uint mask = uint(m_slots.size()) - 1;
+        for (uint i = qHashBits(str, length) & mask; ; i = (i + 1) & mask) {
+            const int slot = m_slots.at(int(i));
+            if (slot == 0)
+                return false;
+
+            const QByteArray &entry = m_entries.at(slot - 1);
+            if (size_t(entry.size()) == length && memcmp(entry.constData(), str, length) == 0)
+                return true;
+        }
+    }
+
+    bool ByteStringSet::isEmpty() const {
+        return m_entries.isEmpty();
+    }
+
+    void ByteStringSet::rehash(int size) {
+        m_slots.fill(0, size);
+
+        const uint mask = uint(size) - 1;
+        for (int id = 0; id < m_entries.size(); ++id) {
+            const QByteArray &entry = m_entries.at(id);
+            uint i = qHashBits(entry.constData(), size_t(entry.size())) & mask;
+            while (m_slots.at(int(i)) != 0)
+                i = (i + 1) & mask;
+            m_slots[int(i)] = id + 1;
+        }
+    }
+
+    UserFilter::Rules::~Rules() {
+        for (regex_t *regex : regexes) {
+            regfree(regex);
+            delete regex;
+        }
+    }
+
+    void UserFilter::Rules::compile(const QStringList &entries) {
+        for (const QString &entry : entries) {
+            const QString trimmed = entry.trimmed();
+            if (trimmed.isEmpty())
+                continue;
+
+            // /regex/
+            if (trimmed.size() > 2 && trimmed.startsWith(QLatin1Char('/')) && trimmed.endsWith(QLatin1Char('/'))) {
+                regex_t *regex = new regex_t;
+                const QByteArray pattern = trimmed.mid(1, trimmed.size() - 2).toLocal8Bit();
+                if (regcomp(regex, pattern.constData(), REG_EXTENDED | REG_NOSUB) != 0) {
+                    qWarning() << "Ignoring invalid regular expression" << trimmed;
+                    delete regex;
+                    continue;
+                }
+                regexes << regex;
+                continue;
+            }
+
+            // glob
+            if (trimmed.contains(QLatin1Char('*')) || trimmed.contains(QLatin1Char('?')) || trimmed.contains(QLatin1Char('['))) {
+                globs << trimmed.toLocal8Bit();
+                continue;
+            }
+
+            literals.insert(trimmed.toLocal8Bit());
+        }
+    }
+
+    bool UserFilter::Rules::matches(const char *str) const {
+        if (!str)
+            return false;
+
+        if (literals.contains(str))
+            return true;
+
+        for (const QByteArray &glob : globs) {
+            if (fnmatch(glob.constData(), str, 0) == 0)
+                return true;
+        }
+
+        for (const regex_t *regex : regexes) {
+            if (regexec(regex, str, 0, nullptr, 0) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    bool UserFilter::Rules::isEmpty() const {
+        return literals.isEmpty() && globs.isEmpty() && regexes.isEmpty();
+    }
+
+    UserFilter::Settings UserFilter::Settings::current() {
+        Settings settings;
+        settings.minimumUid = mainConfig.Users.MinimumUid.get();
+        settings.maximumUid = mainConfig.Users.MaximumUid.get();
+        settings.hideUsers = mainConfig.Users.HideUsers.get();
+        settings.hideShells = mainConfig.Users.HideShells.get();
+        settings.hideGroups = mainConfig.Users.HideGroups.get();
+        return settings;
+    }
+
+    UserFilter::UserFilter() : UserFilter(Settings::current()) {
+    }
+
+    UserFilter::UserFilter(const Settings &settings) {
+        m_minimumUid = settings.minimumUid;
+        m_maximumUid = settings.maximumUid;
+        m_users.compile(settings.hideUsers);
+        m_shells.compile(settings.hideShells);
+
+        // resolve the groups now rather than for every user
+        const long sizeMax = sysconf(_SC_GETGR_R_SIZE_MAX);
+        QByteArray buffer(sizeMax > 0 ? int(sizeMax) : 4096, Qt::Uninitialized);
+        for (const QString &name : settings.hideGroups) {
+            const QByteArray group = name.trimmed().toLocal8Bit();
+            if (group.isEmpty())
+                continue;
+
+            // filters are built on worker threads, getgrnam() isn't reentrant
+            struct group entry;
+            struct group *gr = nullptr;
+            int error;
+            while ((error = getgrnam_r(group.constData(), &entry, buffer.data(), size_t(buffer.size()), &gr)) == ERANGE)
+                buffer.resize(buffer.size() * 2);
+            if (error != 0 || !gr) {
+                qWarning() << "Ignoring unknown group" << name;
+                continue;
+            }
+
+            if (!m_hiddenGids.contains(uint(gr->gr_gid)))
+                m_hiddenGids << uint(gr->gr_gid);
+            for (char **member = gr->gr_mem; member && *member; ++member)
+                m_hiddenMembers.insert(QByteArray(*member));
+        }
+    }
+
+    UserFilter::~UserFilter() {
+    }
+
+    bool UserFilter::accepts(const struct passwd *pw) const {
+        // skip entries with uids outside of the allowed range
+        if (int(pw->pw_uid) < m_minimumUid || int(pw->pw_uid) > m_maximumUid)
+            return false;
+
+        // skip entries with user names in the hide users list
+        if (!m_users.isEmpty() && m_users.matches(pw->pw_name))
+            return false;
+
+        // skip entries with shells in the hide shells list
+        if (!m_shells.isEmpty() && m_shells.matches(pw->pw_shell))
+            return false;
+
+        // skip members of the hidden groups
+        if (m_hiddenGids.contains(uint(pw->pw_gid)) || m_hiddenMembers.contains(pw->pw_name))
+            return false;
+
+        return true;
+    }
+}
@@ -0,0 +1,100 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERFILTER_H
+#define SDDM_USERFILTER_H
+
+#include <QByteArray>
+#include <QStringList>
+#include <QVector>
+
+#include <regex.h>
+
+struct passwd;
+
+namespace SDDM {
+    // Set of byte strings that can be queried with plain C strings
+    class ByteStringSet {
+    public:
+        void insert(const QByteArray &str);
+        bool contains(const char *str) const;
+        bool isEmpty() const;
+
+    private:
+        void rehash(int size);
+
+        QVector<QByteArray> m_entries;
+        // indexes into m_entries plus one, 0 is empty
+        QVector<int> m_slots;
+    };
+
+    // Rules of the [Users] section compiled once, so that filtering
+    // a passwd entry doesn't allocate anything.
+    //
+    // HideUsers and HideShells entries are matched literally, as
+    // fnmatch(3) patterns when they contain wildcards or as POSIX
+    // extended regular expressions when enclosed in slashes.
+    class UserFilter {
+        Q_DISABLE_COPY(UserFilter)
+    public:
+        // The entries of the [Users] section a filter is made of
+        struct Settings {
+            int minimumUid { 0 };
+            int maximumUid { 0 };
+            QStringList hideUsers;
+            QStringList hideShells;
+            QStringList hideGroups;
+
+            // Copied from the configuration, for threads that mustn't
+            // read it
+            static Settings current();
+        };
+
+        // Compiles the current configuration
+        UserFilter();
+        // Compiles settings, the groups are looked up right away
+        explicit UserFilter(const Settings &settings);
+        ~UserFilter();
+
+        bool accepts(const struct passwd *pw) const;
+
+    private:
+        class Rules {
+        public:
+            ~Rules();
+            void compile(const QStringList &entries);
+            bool matches(const char *str) const;
+            bool isEmpty() const;
+
+            ByteStringSet literals;
+            QVector<QByteArray> globs;
+            QVector<regex_t *> regexes;
+        };
+
+        int m_minimumUid { 0 };
+        int m_maximumUid { 0 };
+        Rules m_users;
+        Rules m_shells;
+        // primary groups and members of the hidden groups
+        QVector<uint> m_hiddenGids;
+        ByteStringSet m_hiddenMembers;
+    };
+}
+
+#endif // SDDM_USERFILTER_H
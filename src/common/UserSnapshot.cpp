@@ -0,0 +1,308 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "UserSnapshot.h"
+
+#include "Configuration.h"
+#include "Constants.h"
+#include "UserStore.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <string.h>
+
+namespace SDDM {
+    static const char s_magic[8] = { 'S', 'D', 'D', 'M', 'U', 'S', 'R', '\0' };
+    static const quint32 s_version = 1;
+
+    // files whose modification invalidates the snapshot
+    static const char *const s_sources[] = { "/etc/passwd", "/etc/group", "/etc/nsswitch.conf" };
+    static const int s_sourceCount = sizeof(s_sources) / sizeof(s_sources[0]);
+
+    struct SnapshotHeader {
+        char magic[8];
+        quint32 version;
+        quint32 count;
+        // milliseconds since epoch
+        qint64 created;
+        qint64 sourceModified[s_sourceCount];
+        quint64 fingerprint;
+        // size of the string pool in UTF-16 code units
+        quint32 stringsSize;
+        quint32 reserved;
+    };
+
+    typedef UserStore::StringRef StringRef;
+
+    // The file is made of the header followed by one array per column:
+    //   quint32 uid[count], gid[count], flags[count]
+    //   StringRef name[count], realName[count], homeDir[count], icon[count]
+    //   QChar strings[stringsSize]
+    static const int s_intColumns = 3;
+    static const int s_stringColumns = 4;
+
+    static qint64 expectedSize(quint32 count, quint32 stringsSize) {
+        return qint64(sizeof(SnapshotHeader))
+                + qint64(count) * (s_intColumns * sizeof(quint32) + s_stringColumns * sizeof(StringRef))
+                + qint64(stringsSize) * sizeof(QChar);
+    }
+
+    static qint64 sourceModified(int source) {
+        QFileInfo info(QString::fromLatin1(s_sources[source]));
+        return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+    }
+
+    // Hash of all the settings that affect the content of the snapshot
+    quint64 UserSnapshot::configFingerprint() {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(mainConfig.Users.MinimumUid.value().toUtf8());
+        hash.addData(mainConfig.Users.MaximumUid.value().toUtf8());
+        hash.addData(mainConfig.Users.HideUsers.value().toUtf8());
+        hash.addData(mainConfig.Users.HideShells.value().toUtf8());
+        hash.addData(mainConfig.Users.HideGroups.value().toUtf8());
+        hash.addData(mainConfig.Theme.FacesDir.value().toUtf8());
+
+        quint64 fingerprint = 0;
+        memcpy(&fingerprint, hash.result().constData(), sizeof(fingerprint));
+        return fingerprint;
+    }
+
+    class UserSnapshotPrivate {
+    public:
+        QFile file;
+        uchar *data { nullptr };
+        const SnapshotHeader *header { nullptr };
+        const quint32 *uids { nullptr };
+        const quint32 *gids { nullptr };
+        const quint32 *flags { nullptr };
+        const StringRef *names { nullptr };
+        const StringRef *realNames { nullptr };
+        const StringRef *homeDirs { nullptr };
+        const StringRef *icons { nullptr };
+        const QChar *strings { nullptr };
+
+        QString string(const StringRef *column, int row) const {
+            if (!header || row < 0 || quint32(row) >= header->count)
+                return QString();
+            const StringRef &ref = column[row];
+            if (quint64(ref.offset) + ref.length > header->stringsSize)
+                return QString();
+            return QString(strings + ref.offset, int(ref.length));
+        }
+    };
+
+    UserSnapshot::UserSnapshot() : d(new UserSnapshotPrivate()) {
+    }
+
+    UserSnapshot::~UserSnapshot() {
+        close();
+        delete d;
+    }
+
+    QString UserSnapshot::defaultPath() {
+        return QStringLiteral(RUNTIME_DIR "/users.cache");
+    }
+
+    QStringList UserSnapshot::sourceFiles() {
+        QStringList files;
+        for (int i = 0; i < s_sourceCount; ++i)
+            files << QString::fromLatin1(s_sources[i]);
+        return files;
+    }
+
+    bool UserSnapshot::write(const QString &path, UserStore users, quint64 fingerprint) {
+        // the store already has the layout of the file, it only needs
+        // to be sorted so that greeters can look users up by name
+        users.sortByName();
+
+        const int count = users.count();
+        const QString &strings = users.m_strings;
+
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, s_magic, sizeof(header.magic));
+        header.version = s_version;
+        header.count = quint32(count);
+        header.created = QDateTime::currentMSecsSinceEpoch();
+        for (int i = 0; i < s_sourceCount; ++i)
+            header.sourceModified[i] = sourceModified(i);
+        header.fingerprint = fingerprint;
+        header.stringsSize = quint32(strings.size());
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Failed to write user snapshot" << path << file.errorString();
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(users.m_uids.constData()), count * sizeof(quint32));
+        file.write(reinterpret_cast<const char *>(users.m_gids.constData()), count * sizeof(quint32));
+        file.write(reinterpret_cast<const char *>(users.m_flags.constData()), count * sizeof(quint32));
+        file.write(reinterpret_cast<const char *>(users.m_names.constData()), count * sizeof(StringRef));
+        file.write(reinterpret_cast<const char *>(users.m_realNames.constData()), count * sizeof(StringRef));
+        file.write(reinterpret_cast<const char *>(users.m_homeDirs.constData()), count * sizeof(StringRef));
+        file.write(reinterpret_cast<const char *>(users.m_icons.constData()), count * sizeof(StringRef));
+        file.write(reinterpret_cast<const char *>(strings.constData()), strings.size() * sizeof(QChar));
+
+        // greeters run as an unprivileged user
+        file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner |
+                            QFileDevice::ReadGroup | QFileDevice::ReadOther);
+
+        if (!file.commit()) {
+            qWarning() << "Failed to write user snapshot" << path << file.errorString();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool UserSnapshot::open(const QString &path) {
+        close();
+
+        const int timeout = mainConfig.Users.CacheTimeout.get();
+        if (timeout <= 0)
+            return false;
+
+        d->file.setFileName(path);
+        if (!d->file.open(QIODevice::ReadOnly))
+            return false;
+
+        const qint64 size = d->file.size();
+        if (size < qint64(sizeof(SnapshotHeader))) {
+            close();
+            return false;
+        }
+
+        d->data = d->file.map(0, size);
+        if (!d->data) {
+            close();
+            return false;
+        }
+
+        const uchar *data = d->data;
+        const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(data);
+        if (memcmp(header->magic, s_magic, sizeof(s_magic)) != 0 || header->version != s_version ||
+                expectedSize(header->count, header->stringsSize) != size) {
+            qWarning() << "Ignoring corrupted user snapshot" << path;
+            close();
+            return false;
+        }
+
+        // stale?
+        bool valid = header->created + qint64(timeout) * 1000 >= QDateTime::currentMSecsSinceEpoch() &&
+                header->fingerprint == configFingerprint();
+        for (int i = 0; valid && i < s_sourceCount; ++i)
+            valid = header->sourceModified[i] == sourceModified(i);
+        if (!valid) {
+            close();
+            return false;
+        }
+
+        const quint32 count = header->count;
+        d->header = header;
+        d->uids = reinterpret_cast<const quint32 *>(data + sizeof(SnapshotHeader));
+        d->gids = d->uids + count;
+        d->flags = d->gids + count;
+        d->names = reinterpret_cast<const StringRef *>(d->flags + count);
+        d->realNames = d->names + count;
+        d->homeDirs = d->realNames + count;
+        d->icons = d->homeDirs + count;
+        d->strings = reinterpret_cast<const QChar *>(d->icons + count);
+
+        return true;
+    }
+
+    void UserSnapshot::close() {
+        d->header = nullptr;
+        d->uids = d->gids = d->flags = nullptr;
+        d->names = d->realNames = d->homeDirs = d->icons = nullptr;
+        d->strings = nullptr;
+        if (d->data) {
+            d->file.unmap(d->data);
+            d->data = nullptr;
+        }
+        d->file.close();
+    }
+
+    bool UserSnapshot::isOpen() const {
+        return d->header != nullptr;
+    }
+
+    int UserSnapshot::count() const {
+        return d->header ? int(d->header->count) : 0;
+    }
+
+    QString UserSnapshot::name(int row) const {
+        return d->string(d->names, row);
+    }
+
+    QString UserSnapshot::realName(int row) const {
+        return d->string(d->realNames, row);
+    }
+
+    QString UserSnapshot::homeDir(int row) const {
+        return d->string(d->homeDirs, row);
+    }
+
+    QString UserSnapshot::icon(int row) const {
+        return d->string(d->icons, row);
+    }
+
+    bool UserSnapshot::needsPassword(int row) const {
+        if (row < 0 || row >= count())
+            return false;
+        return d->flags[row] & UserStore::NeedsPasswordFlag;
+    }
+
+    int UserSnapshot::uid(int row) const {
+        if (row < 0 || row >= count())
+            return -1;
+        return int(d->uids[row]);
+    }
+
+    int UserSnapshot::gid(int row) const {
+        if (row < 0 || row >= count())
+            return -1;
+        return int(d->gids[row]);
+    }
+
+    int UserSnapshot::indexOf(const QString &name) const {
+        // rows are sorted by name, compare in place without copying
+        auto lessThan = [this](const StringRef &ref, const QString &name) {
+            if (quint64(ref.offset) + ref.length > d->header->stringsSize)
+                return false;
+            const QChar *begin = d->strings + ref.offset;
+            return std::lexicographical_compare(begin, begin + ref.length, name.constBegin(), name.constEnd(),
+                                                [](QChar c1, QChar c2) { return c1.unicode() < c2.unicode(); });
+        };
+
+        const StringRef *end = d->names + count();
+        const StringRef *it = std::lower_bound(d->names, end, name, lessThan);
+        if (it == end || this->name(int(it - d->names)) != name)
+            return -1;
+        return int(it - d->names);
+    }
+}
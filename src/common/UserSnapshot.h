@@ -0,0 +1,74 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERSNAPSHOT_H
+#define SDDM_USERSNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+
+namespace SDDM {
+    class UserStore;
+    class UserSnapshotPrivate;
+
+    // Binary image of the filtered user list, written by the daemon and
+    // memory mapped read-only by the greeters so they don't have to walk
+    // the whole passwd database themselves.
+    class UserSnapshot {
+        Q_DISABLE_COPY(UserSnapshot)
+    public:
+        UserSnapshot();
+        ~UserSnapshot();
+
+        static QString defaultPath();
+        // System files the snapshot is invalidated by
+        static QStringList sourceFiles();
+
+        // Hash of the current settings that affect the users listed
+        static quint64 configFingerprint();
+        // Writes users sorted by name to path, replacing it atomically.
+        // fingerprint is that of the settings the users were filtered
+        // with, the configuration isn't read.
+        static bool write(const QString &path, UserStore users, quint64 fingerprint);
+
+        // Maps the snapshot at path, fails if the file is missing, corrupted
+        // or stale with respect to the system user database and the
+        // current configuration
+        bool open(const QString &path);
+        void close();
+        bool isOpen() const;
+
+        int count() const;
+        QString name(int row) const;
+        QString realName(int row) const;
+        QString homeDir(int row) const;
+        QString icon(int row) const;
+        bool needsPassword(int row) const;
+        int uid(int row) const;
+        int gid(int row) const;
+
+        // Row of the user called name, -1 if there is no such user
+        int indexOf(const QString &name) const;
+
+    private:
+        UserSnapshotPrivate *d { nullptr };
+    };
+}
+
+#endif // SDDM_USERSNAPSHOT_H
@@ -0,0 +1,229 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "UserStore.h"
+
+#include "UserDatabase.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace SDDM {
+    template <typename T>
+    static void permute(QVector<T> &column, const QVector<int> &order) {
+        QVector<T> sorted;
+        sorted.reserve(column.size());
+        for (int row : order)
+            sorted.append(column.at(row));
+        column = sorted;
+    }
+
+    void UserStore::reserve(int count) {
+        m_uids.reserve(count);
+        m_gids.reserve(count);
+        m_flags.reserve(count);
+        m_names.reserve(count);
+        m_realNames.reserve(count);
+        m_homeDirs.reserve(count);
+        m_icons.reserve(count);
+        m_uidIndex.reserve(count);
+    }
+
+    void UserStore::clear() {
+        m_uids.clear();
+        m_gids.clear();
+        m_flags.clear();
+        m_names.clear();
+        m_realNames.clear();
+        m_homeDirs.clear();
+        m_icons.clear();
+        m_strings.clear();
+        m_interned.clear();
+        m_slots.clear();
+        m_uidIndex.clear();
+    }
+
+    int UserStore::append(const UserRecord &user) {
+        // skip duplicates
+        if (m_uidIndex.contains(quint32(user.uid)))
+            return -1;
+
+        const int row = m_uids.size();
+        m_uidIndex.insert(quint32(user.uid), row);
+
+        m_uids.append(quint32(user.uid));
+        m_gids.append(quint32(user.gid));
+        m_flags.append(user.needsPassword ? NeedsPasswordFlag : 0);
+        m_names.append(intern(user.name));
+        m_realNames.append(intern(user.realName));
+        m_homeDirs.append(intern(user.homeDir));
+        m_icons.append(intern(user.icon));
+
+        return row;
+    }
+
+    int UserStore::count() const {
+        return m_uids.size();
+    }
+
+    UserRecord UserStore::at(int row) const {
+        UserRecord user;
+        if (row < 0 || row >= count())
+            return user;
+
+        user.name = name(row);
+        user.realName = realName(row);
+        user.homeDir = homeDir(row);
+        user.icon = icon(row);
+        user.needsPassword = needsPassword(row);
+        user.uid = uid(row);
+        user.gid = gid(row);
+        return user;
+    }
+
+    QString UserStore::name(int row) const {
+        return string(m_names, row);
+    }
+
+    QString UserStore::realName(int row) const {
+        return string(m_realNames, row);
+    }
+
+    QString UserStore::homeDir(int row) const {
+        return string(m_homeDirs, row);
+    }
+
+    QString UserStore::icon(int row) const {
+        return string(m_icons, row);
+    }
+
+    bool UserStore::needsPassword(int row) const {
+        if (row < 0 || row >= count())
+            return false;
+        return m_flags.at(row) & NeedsPasswordFlag;
+    }
+
+    int UserStore::uid(int row) const {
+        if (row < 0 || row >= count())
+            return -1;
+        return int(m_uids.at(row));
+    }
+
+    int UserStore::gid(int row) const {
+        if (row < 0 || row >= count())
+            return -1;
+        return int(m_gids.at(row));
+    }
+
+    void UserStore::setIcon(int row, const QString &icon) {
+        if (row < 0 || row >= count())
+            return;
+        m_icons[row] = intern(icon);
+    }
+
+    int UserStore::indexOfUid(int uid) const {
+        return m_uidIndex.value(quint32(uid), -1);
+    }
+
+    int UserStore::compareName(int row, const QString &name) const {
+        return stringRef(m_names.at(row)).compare(name);
+    }
+
+    bool UserStore::nameLessThan(int row1, int row2) const {
+        return stringRef(m_names.at(row1)) < stringRef(m_names.at(row2));
+    }
+
+    void UserStore::sortByName() {
+        QVector<int> order(count());
+        for (int i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [this](int row1, int row2) { return nameLessThan(row1, row2); });
+
+        // strings stay where they are, only the columns are permuted
+        permute(m_uids, order);
+        permute(m_gids, order);
+        permute(m_flags, order);
+        permute(m_names, order);
+        permute(m_realNames, order);
+        permute(m_homeDirs, order);
+        permute(m_icons, order);
+
+        for (int row = 0; row < m_uids.size(); ++row)
+            m_uidIndex[m_uids.at(row)] = row;
+    }
+
+    qint64 UserStore::memoryUsage() const {
+        return qint64(m_uids.capacity() + m_gids.capacity() + m_flags.capacity()) * sizeof(quint32)
+                + qint64(m_names.capacity() + m_realNames.capacity() + m_homeDirs.capacity() + m_icons.capacity()) * sizeof(StringRef)
+                + qint64(m_strings.capacity()) * sizeof(QChar)
+                + qint64(m_interned.capacity()) * sizeof(StringRef)
+                + qint64(m_slots.capacity()) * sizeof(quint32)
+                // key, value and next pointer of each node
+                + qint64(m_uidIndex.capacity()) * sizeof(void *)
+                + qint64(m_uidIndex.size()) * (sizeof(void *) * 2 + sizeof(quint32) + sizeof(int));
+    }
+
+    UserStore::StringRef UserStore::intern(const QString &str) {
+        // keep the table at most half full
+        if ((m_interned.size() + 1) * 2 > m_slots.size())
+            rehash(qMax(64, m_slots.size() * 2));
+
+        const uint mask = uint(m_slots.size()) - 1;
+        for (uint i = qHash(str) & mask; ; i = (i + 1) & mask) {
+            const quint32 slot = m_slots.at(int(i));
+
+            // not interned yet
+            if (slot == 0) {
+                const StringRef ref { quint32(m_strings.size()), quint32(str.size()) };
+                m_strings.append(str);
+                m_interned.append(ref);
+                m_slots[int(i)] = quint32(m_interned.size());
+                return ref;
+            }
+
+            const StringRef &ref = m_interned.at(int(slot - 1));
+            if (ref.length == quint32(str.size()) &&
+                    memcmp(m_strings.constData() + ref.offset, str.constData(), ref.length * sizeof(QChar)) == 0)
+                return ref;
+        }
+    }
+
+    void UserStore::rehash(int size) {
+        m_slots.fill(0, size);
+
+        const uint mask = uint(size) - 1;
+        for (int id = 0; id < m_interned.size(); ++id) {
+            uint i = qHash(stringRef(m_interned.at(id))) & mask;
+            while (m_slots.at(int(i)) != 0)
+                i = (i + 1) & mask;
+            m_slots[int(i)] = quint32(id + 1);
+        }
+    }
+
+    QString UserStore::string(const QVector<StringRef> &column, int row) const {
+        if (row < 0 || row >= column.size())
+            return QString();
+        const StringRef &ref = column.at(row);
+        return QString(m_strings.constData() + ref.offset, int(ref.length));
+    }
+
+    QStringRef UserStore::stringRef(const StringRef &ref) const {
+        return QStringRef(&m_strings, int(ref.offset), int(ref.length));
+    }
+}
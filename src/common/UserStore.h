@@ -0,0 +1,104 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERSTORE_H
+#define SDDM_USERSTORE_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+namespace SDDM {
+    class UserRecord;
+
+    // Contiguous table of users: one array per column and all strings
+    // interned in a single pool, rows are indexed by uid.
+    class UserStore {
+    public:
+        enum Flag {
+            NeedsPasswordFlag = 0x1
+        };
+
+        // Range of UTF-16 code units in the string pool
+        struct StringRef {
+            quint32 offset;
+            quint32 length;
+        };
+
+        void reserve(int count);
+        void clear();
+
+        // Appends user and returns its row, returns -1 without storing
+        // anything if a user with the same uid is already present
+        int append(const UserRecord &user);
+
+        int count() const;
+        UserRecord at(int row) const;
+        QString name(int row) const;
+        QString realName(int row) const;
+        QString homeDir(int row) const;
+        QString icon(int row) const;
+        bool needsPassword(int row) const;
+        int uid(int row) const;
+        int gid(int row) const;
+
+        void setIcon(int row, const QString &icon);
+
+        // Row of the user with the given uid, -1 if there is no such user
+        int indexOfUid(int uid) const;
+
+        // Compares names without copying them out of the pool
+        int compareName(int row, const QString &name) const;
+        bool nameLessThan(int row1, int row2) const;
+
+        // Reorders rows by user name
+        void sortByName();
+
+        // Approximate number of bytes allocated by the store
+        qint64 memoryUsage() const;
+
+    private:
+        friend class UserSnapshot;
+
+        StringRef intern(const QString &str);
+        void rehash(int size);
+        QString string(const QVector<StringRef> &column, int row) const;
+        QStringRef stringRef(const StringRef &ref) const;
+
+        QVector<quint32> m_uids;
+        QVector<quint32> m_gids;
+        QVector<quint32> m_flags;
+        QVector<StringRef> m_names;
+        QVector<StringRef> m_realNames;
+        QVector<StringRef> m_homeDirs;
+        QVector<StringRef> m_icons;
+
+        // string pool and the open addressed table used to intern it,
+        // slots hold indexes into m_interned plus one, 0 is empty
+        QString m_strings;
+        QVector<StringRef> m_interned;
+        QVector<quint32> m_slots;
+
+        QHash<quint32, int> m_uidIndex;
+    };
+}
+
+Q_DECLARE_TYPEINFO(SDDM::UserStore::StringRef, Q_PRIMITIVE_TYPE);
+
+#endif // SDDM_USERSTORE_H
@@ -19,12 +19,16 @@
 
 #include "DaemonApp.h"
 
+#include "ConfigNotifier.h"
+#include "ConfigSaver.h"
 #include "Configuration.h"
 #include "Constants.h"
 #include "DisplayManager.h"
 #include "PowerManager.h"
 #include "SeatManager.h"
 #include "SignalHandler.h"
+#include "SessionCache.h"
+#include "UserCache.h"
 
 #include "MessageHandler.h"
 
@@ -49,6 +53,25 @@ namespace SDDM {
         // set testing parameter
         m_testing = (arguments().indexOf(QStringLiteral("--test-mode")) != -1);
 
+        // create session and user caches, greeters read the session and
+        // user lists from them
+        m_sessionCache = new SessionCache(this);
+        m_userCache = new UserCache(this);
+
+        // greeters and helpers map the merged configuration instead of
+        // parsing the files again
+        mainConfig.setWriteSnapshot(true);
+        mainConfig.writeSnapshot();
+
+        // reload the configuration when it changes, everything else reads
+        // it when needed and only the caches have to be told. Seats load
+        // it through the notifier, they are created right away.
+        m_configNotifier = new ConfigNotifier(&mainConfig, this);
+        connect(m_configNotifier, &ConfigNotifier::entryChanged, m_sessionCache, &SessionCache::configChanged);
+        connect(m_configNotifier, &ConfigNotifier::entryChanged, m_userCache, &UserCache::configChanged);
+        // the user snapshot is built on a thread of its own
+        connect(m_configNotifier, &ConfigNotifier::aboutToReload, m_userCache, &UserCache::interrupt);
+
         // create display manager
         m_displayManager = new DisplayManager(this);
 
@@ -62,14 +85,20 @@ namespace SDDM {
         connect(m_seatManager, SIGNAL(seatCreated(QString)), m_displayManager, SLOT(AddSeat(QString)));
         connect(m_seatManager, SIGNAL(seatRemoved(QString)), m_displayManager, SLOT(RemoveSeat(QString)));
 
+        // last user and session, written in the background after logins
+        m_stateSaver = new ConfigSaver(&stateConfig, this);
+
         // create signal handler
         m_signalHandler = new SignalHandler(this);
 
         // initialize signal signalHandler
         SignalHandler::initialize();
 
-        // quit when SIGHUP, SIGINT, SIGTERM received
-        connect(m_signalHandler, SIGNAL(sighupReceived()), this, SLOT(quit()));
+        // reload the configuration when SIGHUP received, running displays
+        // keep going and pick up the new values the next time they need them
+        connect(m_signalHandler, SIGNAL(sighupReceived()), m_configNotifier, SLOT(reload()));
+
+        // quit when SIGINT, SIGTERM received
         connect(m_signalHandler, SIGNAL(sigintReceived()), this, SLOT(quit()));
         connect(m_signalHandler, SIGNAL(sigtermReceived()), this, SLOT(quit()));
 
@@ -86,6 +115,14 @@ namespace SDDM {
         return QHostInfo::localHostName();
     }
 
+    ConfigNotifier *DaemonApp::configNotifier() const {
+        return m_configNotifier;
+    }
+
+    ConfigSaver *DaemonApp::stateSaver() const {
+        return m_stateSaver;
+    }
+
     DisplayManager *DaemonApp::displayManager() const {
         return m_displayManager;
     }
@@ -102,6 +139,14 @@ namespace SDDM {
         return m_signalHandler;
     }
 
+    SessionCache *DaemonApp::sessionCache() const {
+        return m_sessionCache;
+    }
+
+    UserCache *DaemonApp::userCache() const {
+        return m_userCache;
+    }
+
     int DaemonApp::newSessionId() {
         return m_lastSessionId++;
     }
@@ -117,7 +162,8 @@ int main(int argc, char **argv) {
         std::cout << "Usage: sddm [options]\n"
                   << "Options: \n"
                   << "  --test-mode         Start daemon in test mode" << std::endl
-                  << "  --example-config    Print the complete current configuration to stdout" << std::endl;
+                  << "  --example-config    Print the complete current configuration to stdout" << std::endl
+                  << "  --dump-config       Print the effective configuration and where each value comes from" << std::endl;
 
         return EXIT_FAILURE;
     }
@@ -129,6 +175,12 @@ int main(int argc, char **argv) {
         return EXIT_SUCCESS;
     }
 
+    // show which file and line every value was read from
+    if (arguments.contains(QStringLiteral("--dump-config"))) {
+        QTextStream(stdout) << SDDM::mainConfig.toConfigOrigins();
+        return EXIT_SUCCESS;
+    }
+
     // create application
     SDDM::DaemonApp app(argc, argv);
 
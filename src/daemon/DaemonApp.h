@@ -25,11 +25,15 @@
 #define daemonApp DaemonApp::instance()
 
 namespace SDDM {
+    class ConfigNotifier;
+    class ConfigSaver;
     class Configuration;
     class DisplayManager;
     class PowerManager;
     class SeatManager;
     class SignalHandler;
+    class SessionCache;
+    class UserCache;
 
     class DaemonApp : public QCoreApplication {
         Q_OBJECT
@@ -44,10 +48,14 @@ namespace SDDM {
         bool first { true };
 
         QString hostName() const;
+        ConfigNotifier *configNotifier() const;
+        ConfigSaver *stateSaver() const;
         DisplayManager *displayManager() const;
         PowerManager *powerManager() const;
         SeatManager *seatManager() const;
         SignalHandler *signalHandler() const;
+        SessionCache *sessionCache() const;
+        UserCache *userCache() const;
 
     public slots:
         int newSessionId();
@@ -58,10 +66,14 @@ namespace SDDM {
         int m_lastSessionId { 0 };
 
         bool m_testing { false };
+        ConfigNotifier *m_configNotifier { nullptr };
+        ConfigSaver *m_stateSaver { nullptr };
         DisplayManager *m_displayManager { nullptr };
         PowerManager *m_powerManager { nullptr };
         SeatManager *m_seatManager { nullptr };
         SignalHandler *m_signalHandler { nullptr };
+        SessionCache *m_sessionCache { nullptr };
+        UserCache *m_userCache { nullptr };
     };
 }
 
@@ -21,11 +21,13 @@
 
 #include "Display.h"
 
+#include "ConfigSaver.h"
 #include "Configuration.h"
 #include "DaemonApp.h"
 #include "DisplayManager.h"
 #include "XorgDisplayServer.h"
 #include "Seat.h"
+#include "SessionCache.h"
 #include "SocketServer.h"
 #include "Greeter.h"
 #include "Utils.h"
@@ -114,26 +116,20 @@ namespace SDDM {
     }
 
     bool Display::attemptAutologin() {
-        Session::Type sessionType = Session::X11Session;
-
         // determine session type
         QString autologinSession = mainConfig.Autologin.Session.get();
         // not configured: try last successful logged in
         if (autologinSession.isEmpty()) {
             autologinSession = stateConfig.Last.Session.get();
         }
-        if (findSessionEntry(mainConfig.X11.SessionDir.get(), autologinSession)) {
-            sessionType = Session::X11Session;
-        } else if (findSessionEntry(mainConfig.Wayland.SessionDir.get(), autologinSession)) {
-            sessionType = Session::WaylandSession;
-        } else {
+        Session session = findSessionEntry(Session::X11Session, autologinSession);
+        if (!session.isValid())
+            session = findSessionEntry(Session::WaylandSession, autologinSession);
+        if (!session.isValid()) {
             qCritical() << "Unable to find autologin session entry" << autologinSession;
             return false;
         }
 
-        Session session;
-        session.setTo(sessionType, autologinSession);
-
         m_auth->setAutologin(true);
         startAuth(mainConfig.Autologin.User.get(), QString(), session);
 
@@ -252,15 +248,19 @@ namespace SDDM {
         return QString();
     }
 
-    bool Display::findSessionEntry(const QDir &dir, const QString &name) const {
-        QString fileName = name;
+    Session Display::findSessionEntry(Session::Type type, const QString &name) const {
+        bool execAllowed = false;
+        Session session = daemonApp->sessionCache()->session(type, name, &execAllowed);
+        if (!session.isValid())
+            return Session();
 
-        // append extension
-        const QString extension = QStringLiteral(".desktop");
-        if (!fileName.endsWith(extension))
-            fileName += extension;
+        // same check as the greeter, which doesn't list such sessions
+        if (!execAllowed) {
+            qWarning() << "Skipping session" << session.fileName() << "since" << session.tryExec() << "is not installed";
+            return Session();
+        }
 
-        return dir.exists(fileName);
+        return session;
     }
 
     void Display::startAuth(const QString &user, const QString &password, const Session &session) {
@@ -364,7 +364,7 @@ namespace SDDM {
                 stateConfig.Last.Session.set(m_sessionName);
             else
                 stateConfig.Last.Session.setDefault();
-            stateConfig.save();
+            daemonApp->stateSaver()->save();
 
             // switch to the new VT for Wayland sessions
             if (m_lastSession.xdgSessionType() == QLatin1String("wayland"))
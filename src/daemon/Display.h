@@ -71,7 +71,7 @@ namespace SDDM {
 
     private:
         QString findGreeterTheme() const;
-        bool findSessionEntry(const QDir &dir, const QString &name) const;
+        Session findSessionEntry(Session::Type type, const QString &name) const;
 
         void startAuth(const QString &user, const QString &password,
                        const Session &session);
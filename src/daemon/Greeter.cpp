@@ -24,11 +24,13 @@
 #include "DaemonApp.h"
 #include "DisplayManager.h"
 #include "Seat.h"
+#include "ThemeCache.h"
 #include "ThemeConfig.h"
 #include "ThemeMetadata.h"
 #include "Display.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
 #include <QtCore/QProcess>
 
 namespace SDDM {
@@ -62,12 +64,15 @@ namespace SDDM {
         if (theme.isEmpty()) {
             m_metadata->setTo(QString());
             m_themeConfig->setTo(QString());
-        } else {
+        } else if (!ThemeCache::read(ThemeCache::path(m_themePath), m_themePath, m_metadata, m_themeConfig)) {
             const QString path = QStringLiteral("%1/metadata.desktop").arg(m_themePath);
             m_metadata->setTo(path);
 
             QString configFile = QStringLiteral("%1/%2").arg(m_themePath).arg(m_metadata->configFile());
             m_themeConfig->setTo(configFile);
+
+            // parsed once for the daemon and all the greeters
+            ThemeCache::write(ThemeCache::path(m_themePath), m_themePath, m_metadata, m_themeConfig);
         }
     }
 
@@ -91,6 +96,8 @@ namespace SDDM {
         QStringList args;
         args << QLatin1String("--socket") << m_socket
              << QLatin1String("--theme") << m_themePath;
+        if (!m_themePath.isEmpty() && QFile::exists(ThemeCache::path(m_themePath)))
+            args << QLatin1String("--theme-cache") << ThemeCache::path(m_themePath);
         if (!platformTheme.isEmpty())
             args << QLatin1String("-platformtheme") << platformTheme;
         if (!style.isEmpty())
@@ -20,6 +20,7 @@
 
 #include "Seat.h"
 
+#include "ConfigNotifier.h"
 #include "Configuration.h"
 #include "DaemonApp.h"
 #include "Display.h"
@@ -53,7 +54,7 @@ namespace SDDM {
 
     void Seat::createDisplay(int terminalId) {
         //reload config if needed
-        mainConfig.load();
+        daemonApp->configNotifier()->load();
         
         if (terminalId == -1) {
                 // find unused terminal
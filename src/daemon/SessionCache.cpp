@@ -0,0 +1,112 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "SessionCache.h"
+
+#include "Configuration.h"
+#include "ExecutableIndex.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+namespace SDDM {
+    // wait for this many milliseconds after a change before rebuilding,
+    // package managers add several files in a row
+    static const int s_refreshDelay = 1000;
+
+    SessionCache::SessionCache(QObject *parent) : QObject(parent) {
+        m_refreshTimer = new QTimer(this);
+        m_refreshTimer->setSingleShot(true);
+        m_refreshTimer->setInterval(s_refreshDelay);
+        connect(m_refreshTimer, &QTimer::timeout, this, &SessionCache::rebuild);
+
+        m_watcher = new QFileSystemWatcher(this);
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &SessionCache::refresh);
+        watch();
+
+        // keep a catalog written by a previous instance if it's current
+        if (!m_catalog.open(SessionCatalog::defaultPath()))
+            rebuild();
+    }
+
+    Session SessionCache::session(Session::Type type, const QString &name, bool *execAllowed) {
+        // logins are rare, make sure not to miss a change still being debounced
+        if (!m_catalog.isCurrent())
+            rebuild();
+
+        if (m_catalog.isOpen()) {
+            int row = m_catalog.indexOf(type, name);
+
+            // the file was edited in place, its Exec and TryExec may differ
+            if (row != -1 && !m_catalog.isCurrent(row)) {
+                rebuild();
+                row = m_catalog.indexOf(type, name);
+            }
+
+            if (row != -1) {
+                if (execAllowed)
+                    *execAllowed = m_catalog.flags(row) & SessionCatalog::ExecAllowedFlag;
+                return m_catalog.session(row);
+            }
+
+            // the catalog has every file of the session directories
+            if (m_catalog.isOpen() && !name.contains(QLatin1Char('/')))
+                return Session();
+        }
+
+        // a file outside of the session directories, or the catalog
+        // couldn't be written
+        Session session(type, name);
+        if (execAllowed)
+            *execAllowed = session.tryExec().isEmpty() || ExecutableIndex::contains(session.tryExec(), mainConfig.Users.DefaultPath.get());
+        return session;
+    }
+
+    void SessionCache::refresh() {
+        m_refreshTimer->start();
+    }
+
+    void SessionCache::configChanged(const QString &section, const QString &name) {
+        // session directories and the path TryExec is looked up in
+        if (name == QLatin1String("SessionDir") || (section == QLatin1String("Users") && name == QLatin1String("DefaultPath")))
+            refresh();
+    }
+
+    void SessionCache::rebuild() {
+        m_refreshTimer->stop();
+        m_catalog.close();
+
+        QDir().mkpath(QFileInfo(SessionCatalog::defaultPath()).path());
+        if (!SessionCatalog::write(SessionCatalog::defaultPath()) || !m_catalog.open(SessionCatalog::defaultPath()))
+            qWarning() << "Failed to update the session catalog" << SessionCatalog::defaultPath();
+
+        // directories may have been created or removed meanwhile
+        watch();
+    }
+
+    void SessionCache::watch() {
+        for (const QString &dir : SessionCatalog::sourceDirectories()) {
+            if (!m_watcher->directories().contains(dir) && QFileInfo(dir).isDir())
+                m_watcher->addPath(dir);
+        }
+    }
+}
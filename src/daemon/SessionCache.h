@@ -0,0 +1,60 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_SESSIONCACHE_H
+#define SDDM_SESSIONCACHE_H
+
+#include "Session.h"
+#include "SessionCatalog.h"
+
+#include <QObject>
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace SDDM {
+    // Keeps the session catalog read by the greeters up to date and
+    // looks sessions up in it for the daemon
+    class SessionCache : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(SessionCache)
+    public:
+        explicit SessionCache(QObject *parent = 0);
+
+        // Session of the given type called name, invalid if there is no
+        // such session. execAllowed tells whether its TryExec is installed.
+        Session session(Session::Type type, const QString &name, bool *execAllowed = nullptr);
+
+    public slots:
+        void refresh();
+        void configChanged(const QString &section, const QString &name);
+
+    private slots:
+        void rebuild();
+
+    private:
+        void watch();
+
+        QFileSystemWatcher *m_watcher { nullptr };
+        QTimer *m_refreshTimer { nullptr };
+        SessionCatalog m_catalog;
+    };
+}
+
+#endif // SDDM_SESSIONCACHE_H
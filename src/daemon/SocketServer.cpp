@@ -23,6 +23,7 @@
 #include "DaemonApp.h"
 #include "Messages.h"
 #include "PowerManager.h"
+#include "SessionCache.h"
 #include "SocketWriter.h"
 #include "Utils.h"
 
@@ -133,9 +134,12 @@ namespace SDDM {
                 qDebug() << "Message received from greeter: Login";
 
                 // read username, pasword etc.
-                QString user, password, filename;
-                Session session;
-                input >> user >> password >> session;
+                QString user, password, fileName;
+                quint32 type;
+                input >> user >> password >> type >> fileName;
+
+                // the greeter only sends the type and file name of the session
+                Session session = daemonApp->sessionCache()->session(static_cast<Session::Type>(type), fileName);
 
                 // emit signal
                 emit login(socket, user, password, session);
@@ -0,0 +1,199 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "UserCache.h"
+
+#include "Configuration.h"
+#include "UserDatabase.h"
+#include "UserFilter.h"
+#include "UserSnapshot.h"
+#include "UserStore.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QThread>
+#include <QTimer>
+
+namespace SDDM {
+    // wait for this many milliseconds after a change before rebuilding,
+    // tools like useradd touch several files in a row
+    static const int s_refreshDelay = 1000;
+
+    // Enumerates the users with settings copied before it starts, the
+    // configuration can be reloaded meanwhile
+    class UserCacheBuilder : public QThread {
+    public:
+        UserCacheBuilder(QObject *parent) : QThread(parent) { }
+
+        UserFilter::Settings settings;
+        QString defaultFace;
+        quint64 fingerprint { 0 };
+        bool success { false };
+
+    protected:
+        void run() override {
+            UserStore users;
+
+            const UserFilter filter(settings);
+            UserDatabase::enumerate(filter, [this, &users](const UserRecord &user) {
+                users.append(user);
+                return !isInterruptionRequested();
+            });
+
+            if (isInterruptionRequested()) {
+                success = false;
+                return;
+            }
+
+            // avatars are looked up by the greeters for the users they show
+            for (int row = 0; row < users.count(); ++row)
+                users.setIcon(row, defaultFace);
+
+            QDir().mkpath(QFileInfo(UserSnapshot::defaultPath()).path());
+            success = UserSnapshot::write(UserSnapshot::defaultPath(), users, fingerprint);
+        }
+    };
+
+    UserCache::UserCache(QObject *parent) : QObject(parent) {
+        m_builder = new UserCacheBuilder(this);
+        connect(m_builder, &QThread::finished, this, &UserCache::rebuildFinished);
+
+        m_refreshTimer = new QTimer(this);
+        m_refreshTimer->setSingleShot(true);
+        m_refreshTimer->setInterval(s_refreshDelay);
+        connect(m_refreshTimer, &QTimer::timeout, this, &UserCache::rebuild);
+
+        m_expiryTimer = new QTimer(this);
+        connect(m_expiryTimer, &QTimer::timeout, this, &UserCache::rebuild);
+
+        m_watcher = new QFileSystemWatcher(this);
+        connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &UserCache::sourceChanged);
+
+        configure();
+    }
+
+    UserCache::~UserCache() {
+        // an NSS call can take as long as its timeout, a running builder
+        // is left to finish it and goes away on its own
+        disconnect(m_builder, nullptr, this, nullptr);
+        m_builder->requestInterruption();
+        if (m_builder->isRunning()) {
+            m_builder->setParent(nullptr);
+            connect(m_builder, &QThread::finished, m_builder, &QObject::deleteLater);
+        }
+    }
+
+    void UserCache::configure() {
+        const int timeout = mainConfig.Users.CacheTimeout.get();
+
+        // greeters enumerate users by themselves
+        if (timeout <= 0) {
+            m_enabled = false;
+            m_refreshTimer->stop();
+            m_expiryTimer->stop();
+            if (!m_watcher->files().isEmpty())
+                m_watcher->removePaths(m_watcher->files());
+            QFile::remove(UserSnapshot::defaultPath());
+            return;
+        }
+
+        m_enabled = true;
+
+        // rebuild well before the greeters start considering the snapshot stale
+        m_expiryTimer->setInterval(timeout * 1000 / 2);
+
+        for (const QString &path : UserSnapshot::sourceFiles()) {
+            if (!m_watcher->files().contains(path) && QFile::exists(path))
+                m_watcher->addPath(path);
+        }
+
+        rebuild();
+    }
+
+    void UserCache::configChanged(const QString &section, const QString &name) {
+        if (section == QLatin1String("Users") && name == QLatin1String("CacheTimeout"))
+            configure();
+        // filters, faces and the like
+        else if (section == QLatin1String("Users") || section == QLatin1String("Theme"))
+            refresh();
+    }
+
+    void UserCache::refresh() {
+        if (m_enabled)
+            m_refreshTimer->start();
+    }
+
+    void UserCache::interrupt() {
+        if (!m_builder->isRunning())
+            return;
+
+        // the builder doesn't read the configuration, it stops after the
+        // NSS call in progress and starts over from rebuildFinished()
+        m_builder->requestInterruption();
+        m_pending = true;
+    }
+
+    void UserCache::sourceChanged(const QString &path) {
+        // files like /etc/passwd are replaced rather than modified,
+        // watch the new inode
+        m_watcher->removePath(path);
+        if (QFile::exists(path))
+            m_watcher->addPath(path);
+
+        refresh();
+    }
+
+    void UserCache::rebuild() {
+        if (!m_enabled)
+            return;
+
+        // don't run two enumerations at once, start over when done instead
+        if (m_builder->isRunning()) {
+            m_pending = true;
+            return;
+        }
+
+        m_pending = false;
+        m_expiryTimer->start();
+        m_builder->settings = UserFilter::Settings::current();
+        m_builder->defaultFace = UserDatabase::defaultFace();
+        m_builder->fingerprint = UserSnapshot::configFingerprint();
+        m_builder->start(QThread::LowPriority);
+    }
+
+    void UserCache::rebuildFinished() {
+        // disabled meanwhile
+        if (!m_enabled) {
+            QFile::remove(UserSnapshot::defaultPath());
+            return;
+        }
+
+        // interrupted or outdated, start over
+        if (m_pending) {
+            rebuild();
+            return;
+        }
+
+        if (!m_builder->success)
+            qWarning() << "Failed to write the user snapshot to" << UserSnapshot::defaultPath();
+    }
+}
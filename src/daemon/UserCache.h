@@ -0,0 +1,63 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERCACHE_H
+#define SDDM_USERCACHE_H
+
+#include <QObject>
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace SDDM {
+    class UserCacheBuilder;
+
+    // Keeps the user snapshot read by the greeters up to date
+    class UserCache : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(UserCache)
+    public:
+        explicit UserCache(QObject *parent = 0);
+        ~UserCache();
+
+    public slots:
+        void refresh();
+        // Stops a rebuild in progress without waiting for it and starts
+        // it over once it's done, the configuration is about to change
+        void interrupt();
+        void configChanged(const QString &section, const QString &name);
+
+    private slots:
+        void sourceChanged(const QString &path);
+        void rebuild();
+        void rebuildFinished();
+
+    private:
+        void configure();
+
+        QFileSystemWatcher *m_watcher { nullptr };
+        QTimer *m_refreshTimer { nullptr };
+        QTimer *m_expiryTimer { nullptr };
+        UserCacheBuilder *m_builder { nullptr };
+        bool m_enabled { false };
+        bool m_pending { false };
+    };
+}
+
+#endif // SDDM_USERCACHE_H
@@ -20,6 +20,7 @@
 
 #include "XorgDisplayServer.h"
 
+#include "ConfigNotifier.h"
 #include "Configuration.h"
 #include "DaemonApp.h"
 #include "Display.h"
@@ -314,7 +315,7 @@ namespace SDDM {
             displayScript->kill();
 
         // reload config if needed
-        mainConfig.load();
+        daemonApp->configNotifier()->load();
     }
 
     void XorgDisplayServer::changeOwner(const QString &fileName) {
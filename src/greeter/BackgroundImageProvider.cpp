@@ -0,0 +1,204 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "BackgroundImageProvider.h"
+
+#include "StatCache.h"
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUrl>
+
+#include <utime.h>
+
+namespace SDDM {
+    // scaled backgrounds kept in memory, in bytes, enough for a few screens
+    static const int s_memoryCacheSize = 64 * 1024 * 1024;
+    // cached backgrounds not used for this many days are removed
+    static const int s_cacheDays = 30;
+
+    struct BackgroundCache {
+        QMutex mutex;
+        // scaled backgrounds by path, modification time, mode, size and
+        // pixel ratio
+        QCache<QString, QImage> images { s_memoryCacheSize };
+        // views of the same size ask at the same time, one decodes
+        QMutex decodeMutex;
+        // old pictures were removed from the disk cache, under decodeMutex
+        bool pruned { false };
+    };
+
+    Q_GLOBAL_STATIC(BackgroundCache, s_cache)
+
+    static QString cacheDir() {
+        return QStringLiteral("%1/backgrounds").arg(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    }
+
+    static QImage loadBackground(const QString &path, bool crop, const QSize &target) {
+        QImageReader reader(path);
+        QSize size = reader.size();
+        if (!size.isValid()) {
+            qWarning() << "Failed to read background" << path << reader.errorString();
+            return QImage();
+        }
+
+        // scale while decoding, much cheaper than decoding it all for JPEG
+        size.scale(target, crop ? Qt::KeepAspectRatioByExpanding : Qt::IgnoreAspectRatio);
+        if (reader.supportsOption(QImageIOHandler::ScaledSize))
+            reader.setScaledSize(size);
+
+        QImage image = reader.read();
+        if (image.isNull()) {
+            qWarning() << "Failed to read background" << path << reader.errorString();
+            return QImage();
+        }
+        if (image.size() != size)
+            image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+        // same as Image.PreserveAspectCrop, centered
+        if (crop && size != target) {
+            const QRect rect(QPoint((size.width() - target.width()) / 2, (size.height() - target.height()) / 2), target);
+            image = image.copy(rect);
+        }
+
+        return image;
+    }
+
+    static void pruneCache() {
+        const QDateTime limit = QDateTime::currentDateTime().addDays(-s_cacheDays);
+        QDir dir(cacheDir());
+        for (const QFileInfo &info : dir.entryInfoList(QDir::Files)) {
+            if (info.lastModified() < limit)
+                dir.remove(info.fileName());
+        }
+    }
+
+    static bool cachedImage(const QString &key, QImage *image) {
+        QMutexLocker locker(&s_cache->mutex);
+        if (QImage *cached = s_cache->images.object(key)) {
+            *image = *cached;
+            return true;
+        }
+        return false;
+    }
+
+    BackgroundImageProvider::BackgroundImageProvider() : QQuickImageProvider(QQuickImageProvider::Image, QQmlImageProviderBase::ForceAsynchronousImageLoading) {
+    }
+
+    QImage BackgroundImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize) {
+        Q_UNUSED(requestedSize)
+
+        const QString mode = id.section(QLatin1Char('/'), 0, 0);
+        const QString geometry = id.section(QLatin1Char('/'), 1, 1);
+        const QStringList dimensions = geometry.section(QLatin1Char('@'), 0, 0).split(QLatin1Char('x'));
+        const QUrl url(QUrl::fromPercentEncoding(id.section(QLatin1Char('/'), 2).toUtf8()));
+
+        // the size is in logical pixels, the picture is decoded for
+        // the pixels of the screen
+        bool ok = true;
+        const qreal ratio = geometry.contains(QLatin1Char('@')) ? geometry.section(QLatin1Char('@'), 1).toDouble(&ok) : 1.0;
+        if (!ok || ratio <= 0)
+            return QImage();
+        const QSize target = dimensions.size() == 2 ?
+                QSize(qRound(dimensions.at(0).toInt() * ratio), qRound(dimensions.at(1).toInt() * ratio)) : QSize();
+        if ((mode != QLatin1String("crop") && mode != QLatin1String("stretch")) || target.isEmpty())
+            return QImage();
+
+        QString path;
+        if (url.scheme() == QLatin1String("qrc"))
+            path = QLatin1Char(':') + url.path();
+        else if (url.isLocalFile())
+            path = url.toLocalFile();
+        else
+            return QImage();
+
+        // resources only change along with the greeter
+        const qint64 modified = path.startsWith(QLatin1Char(':')) ? 0 : StatCache::modified(path);
+        if (modified == -1)
+            return QImage();
+
+        const QString key = QStringLiteral("%1|%2|%3|%4x%5@%6").arg(path).arg(modified).arg(mode)
+                .arg(target.width()).arg(target.height()).arg(ratio);
+
+        // scaled already, possibly for another screen
+        QImage image;
+        if (cachedImage(key, &image)) {
+            if (size)
+                *size = image.size();
+            return image;
+        }
+
+        // only misses wait for a decode in progress, which may have been
+        // for the same picture
+        QMutexLocker decodeLocker(&s_cache->decodeMutex);
+        if (cachedImage(key, &image)) {
+            if (size)
+                *size = image.size();
+            return image;
+        }
+
+        // pictures without transparency are stored as JPEG, much faster
+        // to decode than PNG at this size
+        const QString cached = QStringLiteral("%1/%2").arg(cacheDir())
+                .arg(QString::fromLatin1(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex()));
+
+        image.load(cached);
+        if (!image.isNull()) {
+            // still in use, the pruning goes by modification time
+            utime(QFile::encodeName(cached).constData(), nullptr);
+        } else {
+            image = loadBackground(path, mode == QLatin1String("crop"), target);
+            if (image.isNull())
+                return QImage();
+
+            // failing to write the cache is not a problem
+            QDir().mkpath(cacheDir());
+            QSaveFile file(cached);
+            if (file.open(QIODevice::WriteOnly) &&
+                    image.save(&file, image.hasAlphaChannel() ? "PNG" : "JPEG", image.hasAlphaChannel() ? -1 : 95))
+                file.commit();
+        }
+        image.setDevicePixelRatio(ratio);
+
+        // on a worker thread, not in the way of the first frame, and
+        // after the picture in use was refreshed
+        if (!s_cache->pruned) {
+            s_cache->pruned = true;
+            pruneCache();
+        }
+
+        {
+            QMutexLocker locker(&s_cache->mutex);
+            s_cache->images.insert(key, new QImage(image), image.byteCount());
+        }
+
+        if (size)
+            *size = image.size();
+        return image;
+    }
+}
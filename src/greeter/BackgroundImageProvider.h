@@ -0,0 +1,41 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_BACKGROUNDIMAGEPROVIDER_H
+#define SDDM_BACKGROUNDIMAGEPROVIDER_H
+
+#include <QQuickImageProvider>
+
+namespace SDDM {
+    // Serves backgrounds as image://sddm-background/<mode>/<size>/<url>,
+    // where mode is crop or stretch, size is the size of the screen as
+    // <width>x<height>, optionally followed by @<device pixel ratio>, and
+    // url the percent encoded file or qrc url of the picture. Pictures
+    // are scaled while decoding on a worker thread and kept on disk per
+    // modification time and size, so a greeter showing a picture it
+    // showed before only decodes a picture as big as the screen.
+    class BackgroundImageProvider : public QQuickImageProvider {
+    public:
+        BackgroundImageProvider();
+
+        QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+    };
+}
+
+#endif // SDDM_BACKGROUNDIMAGEPROVIDER_H
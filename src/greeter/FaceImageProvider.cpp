@@ -0,0 +1,161 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "FaceImageProvider.h"
+
+#include "StatCache.h"
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QImageReader>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUrl>
+
+namespace SDDM {
+    // size of faces requested without a source size
+    static const int s_defaultSize = 256;
+    // decoded faces kept in memory, in bytes
+    static const int s_memoryCacheSize = 16 * 1024 * 1024;
+    // thumbnails not written for this many days are removed
+    static const int s_thumbnailDays = 30;
+
+    struct FaceCache {
+        QMutex mutex;
+        // local path of the avatar of each user
+        QHash<QString, QString> faces;
+        // scaled faces by path, modification time and size
+        QCache<QString, QImage> images { s_memoryCacheSize };
+        bool pruned { false };
+    };
+
+    Q_GLOBAL_STATIC(FaceCache, s_cache)
+
+    static QString thumbnailDir() {
+        return QStringLiteral("%1/faces").arg(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    }
+
+    static QImage loadFace(const QString &path, const QSize &requestedSize) {
+        QImageReader reader(path);
+        QSize size = reader.size();
+        if (!size.isValid()) {
+            qWarning() << "Failed to read face" << path << reader.errorString();
+            return QImage();
+        }
+
+        // scale while decoding, cheaper for formats like JPEG
+        QSize target = requestedSize;
+        if (target.width() <= 0 && target.height() <= 0)
+            target = QSize(s_defaultSize, s_defaultSize);
+        else if (target.width() <= 0)
+            target.setWidth(target.height());
+        else if (target.height() <= 0)
+            target.setHeight(target.width());
+
+        // cover the requested size so that themes can crop, never upscale
+        if (size.width() > target.width() || size.height() > target.height()) {
+            size.scale(target, Qt::KeepAspectRatioByExpanding);
+            reader.setScaledSize(size);
+        }
+
+        return reader.read();
+    }
+
+    FaceImageProvider::FaceImageProvider() : QQuickImageProvider(QQuickImageProvider::Image, QQmlImageProviderBase::ForceAsynchronousImageLoading) {
+        // one provider per view, prune thumbnails of old faces only once
+        QMutexLocker locker(&s_cache->mutex);
+        if (s_cache->pruned)
+            return;
+        s_cache->pruned = true;
+
+        const QDateTime limit = QDateTime::currentDateTime().addDays(-s_thumbnailDays);
+        QDir dir(thumbnailDir());
+        for (const QFileInfo &info : dir.entryInfoList(QStringList() << QStringLiteral("*.png"), QDir::Files)) {
+            if (info.lastModified() < limit)
+                dir.remove(info.fileName());
+        }
+    }
+
+    QString FaceImageProvider::setFace(const QString &user, const QString &path) {
+        const qint64 modified = StatCache::modified(path);
+
+        QMutexLocker locker(&s_cache->mutex);
+        s_cache->faces.insert(user, path);
+
+        // the modification time is there for QML's own cache to notice changes
+        return QStringLiteral("image://sddm-face/%1?%2").arg(QString::fromLatin1(QUrl::toPercentEncoding(user))).arg(modified);
+    }
+
+    QImage FaceImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize) {
+        const QString user = QUrl::fromPercentEncoding(id.section(QLatin1Char('?'), 0, 0).toUtf8());
+
+        QString path;
+        {
+            QMutexLocker locker(&s_cache->mutex);
+            path = s_cache->faces.value(user);
+        }
+        if (path.isEmpty())
+            return QImage();
+
+        const qint64 modified = StatCache::modified(path);
+        const QString key = QStringLiteral("%1|%2|%3x%4").arg(path).arg(modified)
+                .arg(requestedSize.width()).arg(requestedSize.height());
+
+        // decoded already, possibly for another view
+        {
+            QMutexLocker locker(&s_cache->mutex);
+            if (QImage *image = s_cache->images.object(key)) {
+                if (size)
+                    *size = image->size();
+                return *image;
+            }
+        }
+
+        const QString thumbnail = QStringLiteral("%1/%2.png").arg(thumbnailDir())
+                .arg(QString::fromLatin1(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex()));
+
+        QImage image(thumbnail);
+        if (image.isNull()) {
+            image = loadFace(path, requestedSize);
+            if (image.isNull())
+                return QImage();
+
+            // failing to write the thumbnail is not a problem
+            QDir().mkpath(thumbnailDir());
+            QSaveFile file(thumbnail);
+            if (file.open(QIODevice::WriteOnly) && image.save(&file, "PNG"))
+                file.commit();
+        }
+
+        {
+            QMutexLocker locker(&s_cache->mutex);
+            s_cache->images.insert(key, new QImage(image), image.byteCount());
+        }
+
+        if (size)
+            *size = image.size();
+        return image;
+    }
+}
@@ -0,0 +1,42 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_FACEIMAGEPROVIDER_H
+#define SDDM_FACEIMAGEPROVIDER_H
+
+#include <QQuickImageProvider>
+
+namespace SDDM {
+    // Serves user avatars as image://sddm-face/<user>, each face is decoded
+    // once per size and shared by all the views. Scaled faces are also kept
+    // in a small thumbnail cache on disk.
+    class FaceImageProvider : public QQuickImageProvider {
+    public:
+        FaceImageProvider();
+
+        QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+
+        // Registers the avatar of user and returns the url serving it,
+        // the url changes along with the modification time of path.
+        // Thread safe.
+        static QString setFace(const QString &user, const QString &path);
+    };
+}
+
+#endif // SDDM_FACEIMAGEPROVIDER_H
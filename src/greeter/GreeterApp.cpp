@@ -19,13 +19,18 @@
 ***************************************************************************/
 
 #include "GreeterApp.h"
+#include "BackgroundImageProvider.h"
 #include "Configuration.h"
+#include "FaceImageProvider.h"
 #include "GreeterProxy.h"
+#include "IdleMonitor.h"
 #include "Constants.h"
 #include "ScreenModel.h"
 #include "SessionModel.h"
+#include "ThemeCache.h"
 #include "ThemeConfig.h"
 #include "ThemeMetadata.h"
+#include "UserFilterModel.h"
 #include "UserModel.h"
 #include "KeyboardModel.h"
 
@@ -34,15 +39,37 @@
 #include <QGuiApplication>
 #include <QQuickItem>
 #include <QQuickView>
+#include <QQmlComponent>
 #include <QQmlContext>
 #include <QQmlEngine>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadPool>
 #include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
 #include <QTimer>
 #include <QTranslator>
 
+#include <functional>
 #include <iostream>
 
+#include <unistd.h>
+
 namespace SDDM {
+    // Resident set of the process in kB, 0 if it's unknown
+    static qint64 residentSetSize() {
+        QFile file(QStringLiteral("/proc/self/statm"));
+        if (!file.open(QIODevice::ReadOnly))
+            return 0;
+        const QList<QByteArray> fields = file.readAll().split(' ');
+        if (fields.size() < 2)
+            return 0;
+        return fields.at(1).toLongLong() * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+
     QString parameter(const QStringList &arguments, const QString &key, const QString &defaultValue) {
         int index = arguments.indexOf(key);
 
@@ -57,11 +84,74 @@ namespace SDDM {
         return value;
     }
 
+    int precompileThemes(const QString &directory) {
+        QQmlEngine engine;
+        engine.addImportPath(QStringLiteral(IMPORTS_INSTALL_DIR));
+        engine.addImportPath(QStringLiteral("qrc:/"));
+
+        // either a single theme or a directory full of them
+        QStringList themes;
+        if (QFile::exists(QStringLiteral("%1/metadata.desktop").arg(directory))) {
+            themes << directory;
+        } else {
+            foreach (const QFileInfo &info, QDir(directory).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+                themes << info.absoluteFilePath();
+        }
+
+        // compiling a file is enough for the engine to cache it
+        int failures = 0;
+        foreach (const QString &theme, themes) {
+            QDirIterator it(theme, QStringList() << QStringLiteral("*.qml"), QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                const QString file = it.next();
+                QQmlComponent component(&engine, QUrl::fromLocalFile(file));
+                if (component.isError()) {
+                    foreach (const QQmlError &e, component.errors())
+                        qWarning() << e;
+                    ++failures;
+                } else {
+                    qDebug() << "Compiled" << file;
+                }
+            }
+        }
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 9, 0)
+        qWarning() << "This version of Qt has no QML disk cache, nothing was stored";
+#endif
+
+        return failures;
+    }
+
+    // A step of the startup, run on a thread pool or right away, logging
+    // how long it took
+    class BootstrapStage : public QRunnable {
+    public:
+        BootstrapStage(const char *name, const QElapsedTimer &startTime, const std::function<void()> &function)
+            : m_name(name), m_startTime(startTime), m_function(function) { }
+
+        void run() override {
+            measure(m_name, m_startTime, m_function);
+        }
+
+        static void measure(const char *name, const QElapsedTimer &startTime, const std::function<void()> &function) {
+            QElapsedTimer timer;
+            timer.start();
+            function();
+            qDebug() << "Bootstrap stage" << name << "took" << timer.elapsed() << "ms, done after" << startTime.elapsed() << "ms";
+        }
+
+    private:
+        const char *m_name;
+        const QElapsedTimer &m_startTime;
+        std::function<void()> m_function;
+    };
+
     GreeterApp *GreeterApp::self = nullptr;
 
     GreeterApp::GreeterApp(int &argc, char **argv) : QGuiApplication(argc, argv) {
         // point instance to this
         self = this;
+        m_startTime.start();
 
         // Parse arguments
         bool testing = false;
@@ -77,52 +167,148 @@ namespace SDDM {
         if (m_themePath.isEmpty())
             m_themePath = QLatin1String("qrc:/theme");
 
-        // read theme metadata
-        m_metadata = new ThemeMetadata(QStringLiteral("%1/metadata.desktop").arg(m_themePath));
+        // startup runs as a small dependency graph:
+        //
+        //   theme, translations ──┐
+        //   engine ───────────────┴─► compile ──┐
+        //                             models ───┴─► views
+        //
+        // the theme and the translations are read on the thread pool while
+        // this thread sets up the engine, then the main script is compiled
+        // by the QML loader thread while this thread creates the models,
+        // which have to live here and are handed to the engine as each is
+        // ready
+        QThreadPool pool;
+
+        m_metadata = new ThemeMetadata(QString());
+        m_themeConfig = new ThemeConfig(QString());
+        const QString themeCache = parameter(arguments(), QStringLiteral("--theme-cache"), QString());
+        QThread *mainThread = thread();
+
+        // read theme metadata and config, as parsed by the daemon if it
+        // could, then the translations of the theme
+        pool.start(new BootstrapStage("theme", m_startTime, [this, themeCache, mainThread]() {
+            if (themeCache.isEmpty() || !ThemeCache::read(themeCache, m_themePath, m_metadata, m_themeConfig)) {
+                m_metadata->setTo(QStringLiteral("%1/metadata.desktop").arg(m_themePath));
+                m_themeConfig->setTo(QStringLiteral("%1/%2").arg(m_themePath).arg(m_metadata->configFile()));
+            }
+
+            // Theme specific translation
+            QTranslator *translator = new QTranslator();
+            if (translator->load(QLocale::system(), QString(), QString(),
+                                 QStringLiteral("%1/%2/").arg(m_themePath, m_metadata->translationsDirectory()))) {
+                translator->moveToThread(mainThread);
+                m_theme_translator = translator;
+            } else {
+                delete translator;
+            }
+        }));
 
-        // Translations
         // Components translation
-        m_components_tranlator = new QTranslator();
-        if (m_components_tranlator->load(QLocale::system(), QString(), QString(), QStringLiteral(COMPONENTS_TRANSLATION_DIR)))
-            installTranslator(m_components_tranlator);
+        pool.start(new BootstrapStage("components translation", m_startTime, [this, mainThread]() {
+            QTranslator *translator = new QTranslator();
+            if (translator->load(QLocale::system(), QString(), QString(), QStringLiteral(COMPONENTS_TRANSLATION_DIR))) {
+                translator->moveToThread(mainThread);
+                m_components_tranlator = translator;
+            } else {
+                delete translator;
+            }
+        }));
+
+        // one engine for all the screens, imports are resolved and the
+        // theme is compiled only once
+        BootstrapStage::measure("engine", m_startTime, [this]() {
+            m_engine = new QQmlEngine(this);
+            m_engine->addImportPath(QStringLiteral(IMPORTS_INSTALL_DIR));
+            // the embedded components come first, they may be compiled already
+            m_engine->addImportPath(QStringLiteral("qrc:/"));
+
+            // avatars and backgrounds are decoded once for all the views
+            m_engine->addImageProvider(QStringLiteral("sddm-face"), new FaceImageProvider());
+            m_engine->addImageProvider(QStringLiteral("sddm-background"), new BackgroundImageProvider());
+            m_engine->rootContext()->setContextProperty(QStringLiteral("__sddm_backgrounds"), true);
+        });
 
-        // Theme specific translation
-        m_theme_translator = new QTranslator();
-        if (m_theme_translator->load(QLocale::system(), QString(), QString(),
-                           QStringLiteral("%1/%2/").arg(m_themePath, m_metadata->translationsDirectory())))
+        // the theme is all the compilation needs
+        pool.waitForDone();
+        if (m_components_tranlator)
+            installTranslator(m_components_tranlator);
+        if (m_theme_translator)
             installTranslator(m_theme_translator);
 
-        // get theme config file
-        QString configFile = QStringLiteral("%1/%2").arg(m_themePath).arg(m_metadata->configFile());
-
-        // read theme config
-        m_themeConfig = new ThemeConfig(configFile);
-
         // set default icon theme from greeter theme
         if (m_themeConfig->contains(QStringLiteral("iconTheme")))
             QIcon::setThemeName(m_themeConfig->value(QStringLiteral("iconTheme")).toString());
 
-        // create models
+        m_engine->rootContext()->setContextProperty(QStringLiteral("config"), *m_themeConfig);
+
+        // get theme main script
+        QString mainScript = QStringLiteral("%1/%2").arg(m_themePath).arg(m_metadata->mainScript());
+        QUrl mainScriptUrl;
+        if (m_themePath.startsWith(QLatin1String("qrc:/")))
+            mainScriptUrl = QUrl(mainScript);
+        else
+            mainScriptUrl = QUrl::fromLocalFile(mainScript);
 
-        m_sessionModel = new SessionModel();
-        m_userModel = new UserModel();
-        m_proxy = new GreeterProxy(socket);
-        m_keyboard = new KeyboardModel();
+        // compile the main script off this thread, each view creates its
+        // own instance once it's done
+        qInfo("Loading %s...", qPrintable(mainScriptUrl.toString()));
+        m_compileTime.start();
+        m_component = new QQmlComponent(m_engine, m_engine);
+        m_component->loadUrl(mainScriptUrl, QQmlComponent::Asynchronous);
+
+        // create models meanwhile, the views are only created from the
+        // event loop so they all get there first
+        QQmlContext *rootContext = m_engine->rootContext();
+        BootstrapStage::measure("sessions", m_startTime, [this, rootContext]() {
+            m_sessionModel = new SessionModel();
+            rootContext->setContextProperty(QStringLiteral("sessionModel"), m_sessionModel);
+        });
+        BootstrapStage::measure("users", m_startTime, [this, rootContext]() {
+            m_userModel = new UserModel();
+            m_userFilterModel = new UserFilterModel(m_userModel);
+            rootContext->setContextProperty(QStringLiteral("userModel"), m_userModel);
+            rootContext->setContextProperty(QStringLiteral("userFilterModel"), m_userFilterModel);
+        });
+        BootstrapStage::measure("daemon", m_startTime, [this, socket, rootContext]() {
+            m_proxy = new GreeterProxy(socket);
+            m_proxy->setSessionModel(m_sessionModel);
+            rootContext->setContextProperty(QStringLiteral("sddm"), m_proxy);
+        });
 
         if(!testing && !m_proxy->isConnected()) {
             qCritical() << "Cannot connect to the daemon - is it running?";
             exit(EXIT_FAILURE);
         }
 
-        // Set numlock upon start
-        if (m_keyboard->enabled()) {
-            if (mainConfig.Numlock.get() == MainConfig::NUM_SET_ON)
-                m_keyboard->setNumLockState(true);
-            else if (mainConfig.Numlock.get() == MainConfig::NUM_SET_OFF)
-                m_keyboard->setNumLockState(false);
-        }
+        BootstrapStage::measure("keyboard", m_startTime, [this, rootContext]() {
+            m_keyboard = new KeyboardModel();
 
-        m_proxy->setSessionModel(m_sessionModel);
+            // Set numlock upon start
+            if (m_keyboard->enabled()) {
+                if (mainConfig.Numlock.get() == MainConfig::NUM_SET_ON)
+                    m_keyboard->setNumLockState(true);
+                else if (mainConfig.Numlock.get() == MainConfig::NUM_SET_OFF)
+                    m_keyboard->setNumLockState(false);
+            }
+            rootContext->setContextProperty(QStringLiteral("keyboard"), m_keyboard);
+        });
+
+        m_idleMonitor = new IdleMonitor(mainConfig.Theme.IdleTimeout.get(), this);
+        rootContext->setContextProperty(QStringLiteral("idleMonitor"), m_idleMonitor);
+
+        // the compilation may be over already, with everything cached
+        connect(m_component, &QQmlComponent::statusChanged, this, &GreeterApp::componentStatusChanged);
+        if (!m_component->isLoading())
+            componentStatusChanged();
+    }
+
+    void GreeterApp::componentStatusChanged() {
+        if (m_component->isLoading() || m_viewsCreated)
+            return;
+        m_viewsCreated = true;
+
+        qDebug() << "Bootstrap stage compile took" << m_compileTime.elapsed() << "ms, done after" << m_startTime.elapsed() << "ms";
 
         // create views
         QList<QScreen *> screens = primaryScreen()->virtualSiblings();
@@ -137,10 +323,9 @@ namespace SDDM {
     }
 
     void GreeterApp::addViewForScreen(QScreen *screen) {
-        // create view
-        QQuickView *view = new QQuickView();
+        // create view, all of them share the engine and the theme
+        QQuickView *view = new QQuickView(m_engine, nullptr);
         view->setScreen(screen);
-        view->setResizeMode(QQuickView::SizeRootObjectToView);
         //view->setGeometry(QRect(QPoint(0, 0), screen->geometry().size()));
         view->setGeometry(screen->geometry());
         m_views.append(view);
@@ -158,8 +343,6 @@ namespace SDDM {
             view->setGeometry(r);
         });
 
-        view->engine()->addImportPath(QStringLiteral(IMPORTS_INSTALL_DIR));
-
         // connect proxy signals
         connect(m_proxy, SIGNAL(loginSucceeded()), view, SLOT(close()));
 
@@ -174,47 +357,43 @@ namespace SDDM {
         // in order to avoid creating items with different sizes.
         ScreenModel *screenModel = new ScreenModel(screen, view);
 
-        // set context properties
-        view->rootContext()->setContextProperty(QStringLiteral("sessionModel"), m_sessionModel);
-        view->rootContext()->setContextProperty(QStringLiteral("screenModel"), screenModel);
-        view->rootContext()->setContextProperty(QStringLiteral("userModel"), m_userModel);
-        view->rootContext()->setContextProperty(QStringLiteral("config"), *m_themeConfig);
-        view->rootContext()->setContextProperty(QStringLiteral("sddm"), m_proxy);
-        view->rootContext()->setContextProperty(QStringLiteral("keyboard"), m_keyboard);
-        view->rootContext()->setContextProperty(QStringLiteral("primaryScreen"), QGuiApplication::primaryScreen() == screen);
-        view->rootContext()->setContextProperty(QStringLiteral("__sddm_errors"), QString());
+        // set the context properties that differ between screens, the
+        // others are on the engine
+        QQmlContext *context = new QQmlContext(m_engine->rootContext(), view);
+        context->setContextProperty(QStringLiteral("screenModel"), screenModel);
+        context->setContextProperty(QStringLiteral("primaryScreen"), QGuiApplication::primaryScreen() == screen);
+        context->setContextProperty(QStringLiteral("__sddm_errors"), QString());
 
-        // get theme main script
-        QString mainScript = QStringLiteral("%1/%2").arg(m_themePath).arg(m_metadata->mainScript());
-        QUrl mainScriptUrl;
-        if (m_themePath.startsWith(QLatin1String("qrc:/")))
-            mainScriptUrl = QUrl(mainScript);
-        else
-            mainScriptUrl = QUrl::fromLocalFile(mainScript);
+        // instantiate the theme
+        QQuickItem *root = createRootItem(m_component, context, view);
 
         // load theme from resources when an error has occurred
-        connect(view, &QQuickView::statusChanged, this, [view](QQuickView::Status status) {
-            if (status != QQuickView::Error)
-                return;
-
+        if (!root) {
             QString errors;
-            Q_FOREACH(const QQmlError &e, view->errors()) {
+            Q_FOREACH(const QQmlError &e, m_component->errors()) {
                 qWarning() << e;
                 errors += QLatin1String("\n") + e.toString();
             }
 
             qWarning() << "Fallback to embedded theme";
-            view->rootContext()->setContextProperty(QStringLiteral("__sddm_errors"), errors);
-            view->setSource(QUrl(QStringLiteral("qrc:/theme/Main.qml")));
-        });
-
-        // set main script as source
-        qInfo("Loading %s...", qPrintable(mainScriptUrl.toString()));
-        view->setSource(mainScriptUrl);
+            context->setContextProperty(QStringLiteral("__sddm_errors"), errors);
+            if (!m_fallbackComponent)
+                m_fallbackComponent = new QQmlComponent(m_engine, QUrl(QStringLiteral("qrc:/theme/Main.qml")), m_engine);
+            root = createRootItem(m_fallbackComponent, context, view);
+        }
 
         // set default cursor
         QCursor cursor(Qt::ArrowCursor);
-        view->rootObject()->setCursor(cursor);
+        if (root)
+            root->setCursor(cursor);
+
+        // log how long it took until the screen showed something
+        const QString name = screen->name();
+        QSharedPointer<QMetaObject::Connection> firstFrame(new QMetaObject::Connection);
+        *firstFrame = connect(view, &QQuickWindow::frameSwapped, this, [this, name, firstFrame]() {
+            qDebug() << "First frame on" << name << "after" << m_startTime.elapsed() << "ms, resident set" << residentSetSize() << "kB";
+            disconnect(*firstFrame);
+        });
 
         // show
         qDebug() << "Adding view for" << screen->name() << screen->geometry();
@@ -225,6 +404,34 @@ namespace SDDM {
             view->requestActivate();
     }
 
+    QQuickItem *GreeterApp::createRootItem(QQmlComponent *component, QQmlContext *context, QQuickView *view) {
+        if (component->isError())
+            return nullptr;
+
+        QObject *object = component->beginCreate(context);
+        QQuickItem *root = qobject_cast<QQuickItem *>(object);
+        if (!root) {
+            // completed before it goes, like any other instance
+            if (object) {
+                qWarning() << component->url() << "doesn't have an Item at its root";
+                component->completeCreate();
+                delete object;
+            }
+            return nullptr;
+        }
+
+        // the view owns the item, which fills its content item and is
+        // sized before the theme's onCompleted handlers run
+        root->setParent(view);
+        root->setParentItem(view->contentItem());
+        root->setSize(view->size());
+        connect(view, &QWindow::widthChanged, root, &QQuickItem::setWidth);
+        connect(view, &QWindow::heightChanged, root, &QQuickItem::setHeight);
+        component->completeCreate();
+
+        return root;
+    }
+
     void GreeterApp::removeViewForScreen(QQuickView *view) {
         // screen is gone, remove the window
         m_views.removeOne(view);
@@ -268,12 +475,24 @@ int main(int argc, char **argv) {
         std::cout << "Usage: " << argv[0] << " [options] [arguments]\n"
                      "Options: \n"
                      "  --theme <theme path>       Set greeter theme\n"
+                     "  --theme-cache <path>       Read the parsed theme from this cache\n"
+                     "  --precompile-theme [dir]   Compile the themes in dir into the QML disk cache and quit\n"
                      "  --socket <socket name>     Set socket name\n"
                      "  --test-mode                Start greeter in test mode" << std::endl;
 
         return EXIT_FAILURE;
     }
 
+    // fill the QML disk cache of the user running this and quit
+    if (arguments.contains(QStringLiteral("--precompile-theme"))) {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+            qputenv("QT_QPA_PLATFORM", "minimal");
+        QGuiApplication app(argc, argv);
+        const QString directory = SDDM::parameter(arguments, QStringLiteral("--precompile-theme"),
+                                                  SDDM::mainConfig.Theme.ThemeDir.get());
+        return SDDM::precompileThemes(directory) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     SDDM::GreeterApp app(argc, argv);
 
     return app.exec();
@@ -21,10 +21,15 @@
 #ifndef GREETERAPP_H
 #define GREETERAPP_H
 
+#include <QElapsedTimer>
 #include <QGuiApplication>
 #include <QScreen>
 #include <QQuickView>
 
+class QQmlComponent;
+class QQmlContext;
+class QQmlEngine;
+class QQuickItem;
 class QTranslator;
 
 namespace SDDM {
@@ -34,7 +39,9 @@ namespace SDDM {
     class SessionModel;
     class ScreenModel;
     class UserModel;
+    class UserFilterModel;
     class GreeterProxy;
+    class IdleMonitor;
     class KeyboardModel;
 
 
@@ -48,12 +55,23 @@ namespace SDDM {
         static GreeterApp *instance() { return self; }
 
     private slots:
+        void componentStatusChanged();
         void addViewForScreen(QScreen *screen);
         void removeViewForScreen(QQuickView *view);
 
     private:
         static GreeterApp *self;
 
+        // Instantiates a theme as the root item of a view, null if it
+        // can't be
+        QQuickItem *createRootItem(QQmlComponent *component, QQmlContext *context, QQuickView *view);
+
+        QElapsedTimer m_startTime;
+        QElapsedTimer m_compileTime;
+        bool m_viewsCreated { false };
+        QQmlEngine *m_engine { nullptr };
+        QQmlComponent *m_component { nullptr };
+        QQmlComponent *m_fallbackComponent { nullptr };
         QList<QQuickView *> m_views;
         QTranslator *m_theme_translator { nullptr },
                     *m_components_tranlator { nullptr };
@@ -63,8 +81,10 @@ namespace SDDM {
         ThemeConfig *m_themeConfig { nullptr };
         SessionModel *m_sessionModel { nullptr };
         UserModel *m_userModel { nullptr };
+        UserFilterModel *m_userFilterModel { nullptr };
         GreeterProxy *m_proxy { nullptr };
         KeyboardModel *m_keyboard { nullptr };
+        IdleMonitor *m_idleMonitor { nullptr };
 
         void activatePrimary();
     };
@@ -117,13 +117,8 @@ namespace SDDM {
             return;
         }
 
-        // get model index
-        QModelIndex index = d->sessionModel->index(sessionIndex, 0);
-
         // send command to the daemon
-        Session::Type type = static_cast<Session::Type>(d->sessionModel->data(index, SessionModel::TypeRole).toInt());
-        QString name = d->sessionModel->data(index, SessionModel::FileRole).toString();
-        Session session(type, name);
+        const Session session = d->sessionModel->session(sessionIndex);
         SocketWriter(d->socket) << quint32(GreeterMessages::Login) << user << password << session;
     }
 
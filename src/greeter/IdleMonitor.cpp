@@ -0,0 +1,123 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "IdleMonitor.h"
+
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEvent>
+#include <QGuiApplication>
+#include <QStyleHints>
+
+namespace SDDM {
+    IdleMonitor::IdleMonitor(int timeout, QObject *parent) : QObject(parent), m_timeout(qMax(0, timeout)) {
+        m_lastInput.start();
+        m_stateTime.start();
+
+        // input only stamps the time, the timer is armed once and checks
+        // how long ago the last input was when it fires
+        m_timer.setSingleShot(true);
+        m_timer.setTimerType(Qt::VeryCoarseTimer);
+        connect(&m_timer, &QTimer::timeout, this, &IdleMonitor::check);
+        if (m_timeout > 0)
+            m_timer.start(m_timeout * 1000);
+
+        if (QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance(thread()))
+            connect(dispatcher, &QAbstractEventDispatcher::awake, this, &IdleMonitor::countWakeup);
+
+        qApp->installEventFilter(this);
+    }
+
+    bool IdleMonitor::isIdle() const {
+        return m_idle;
+    }
+
+    int IdleMonitor::timeout() const {
+        return m_timeout;
+    }
+
+    qreal IdleMonitor::wakeupsPerSecond() const {
+        const qint64 elapsed = m_stateTime.elapsed();
+        if (elapsed <= 0)
+            return 0;
+        return m_wakeups * 1000.0 / elapsed;
+    }
+
+    bool IdleMonitor::eventFilter(QObject *watched, QEvent *event) {
+        switch (event->type()) {
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseMove:
+        case QEvent::Wheel:
+        case QEvent::TouchBegin:
+        case QEvent::TouchUpdate:
+        case QEvent::TabletPress:
+        case QEvent::TabletMove:
+            m_lastInput.restart();
+            if (m_idle) {
+                setIdle(false);
+                if (m_timeout > 0)
+                    m_timer.start(m_timeout * 1000);
+            }
+            break;
+        default:
+            break;
+        }
+
+        return QObject::eventFilter(watched, event);
+    }
+
+    void IdleMonitor::countWakeup() {
+        m_wakeups++;
+    }
+
+    void IdleMonitor::check() {
+        const qint64 remaining = m_timeout * 1000LL - m_lastInput.elapsed();
+        if (remaining > 0)
+            m_timer.start(int(remaining));
+        else
+            setIdle(true);
+    }
+
+    void IdleMonitor::setIdle(bool idle) {
+        if (m_idle == idle)
+            return;
+
+        qDebug() << (idle ? "Going idle after" : "Resuming after") << m_stateTime.elapsed() / 1000
+                 << "s with" << wakeupsPerSecond() << "wakeups/s";
+
+        // a blinking cursor in a focused field repaints the screen twice
+        // a second, it stays still while nobody is looking
+        QStyleHints *hints = QGuiApplication::styleHints();
+        if (idle) {
+            m_cursorFlashTime = hints->cursorFlashTime();
+            hints->setCursorFlashTime(0);
+        } else {
+            hints->setCursorFlashTime(m_cursorFlashTime);
+        }
+
+        m_idle = idle;
+        m_wakeups = 0;
+        m_stateTime.restart();
+        emit idleChanged();
+    }
+}
@@ -0,0 +1,71 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_IDLEMONITOR_H
+#define SDDM_IDLEMONITOR_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+namespace SDDM {
+    // Tells the theme when nobody has used the keyboard, the mouse or the
+    // touchscreen for a while, so it can stop whatever keeps it repainting,
+    // and counts how often the greeter wakes up to check it did. The text
+    // cursor stops blinking meanwhile.
+    class IdleMonitor : public QObject {
+        Q_OBJECT
+        Q_DISABLE_COPY(IdleMonitor)
+        Q_PROPERTY(bool idle READ isIdle NOTIFY idleChanged)
+        Q_PROPERTY(int timeout READ timeout CONSTANT)
+    public:
+        // timeout in seconds, 0 to never become idle
+        explicit IdleMonitor(int timeout, QObject *parent = nullptr);
+
+        bool isIdle() const;
+        int timeout() const;
+        // Average wakeups of the main thread since it last became idle
+        // or active, changes all the time so it's no property
+        Q_INVOKABLE qreal wakeupsPerSecond() const;
+
+    signals:
+        void idleChanged();
+
+    protected:
+        bool eventFilter(QObject *watched, QEvent *event) override;
+
+    private slots:
+        void countWakeup();
+        void check();
+
+    private:
+        void setIdle(bool idle);
+
+        int m_timeout { 0 };
+        bool m_idle { false };
+        QTimer m_timer;
+        QElapsedTimer m_lastInput;
+        QElapsedTimer m_stateTime;
+        quint64 m_wakeups { 0 };
+        // flash time of the text cursor to restore on input
+        int m_cursorFlashTime { 0 };
+    };
+}
+
+#endif // SDDM_IDLEMONITOR_H
@@ -21,38 +21,64 @@
 #include "SessionModel.h"
 
 #include "Configuration.h"
+#include "ExecutableIndex.h"
+#include "SessionCatalog.h"
 
 #include <QVector>
-#include <QProcessEnvironment>
+#include <QPair>
 #include <QFileSystemWatcher>
 
+#include <algorithm>
+
 namespace SDDM {
+    // a session file found in one of the session directories
+    struct SessionFile {
+        Session *session { nullptr };
+        qint64 modified { 0 };
+        // listed in the model
+        bool visible { false };
+    };
+
+    typedef QPair<int, QString> SessionKey;
+
     class SessionModelPrivate {
     public:
         ~SessionModelPrivate() {
-            qDeleteAll(sessions);
+            for (const SessionFile &file : files)
+                delete file.session;
+            files.clear();
             sessions.clear();
         }
 
         int lastIndex { 0 };
+        // visible sessions, sorted by type and file name
         QVector<Session *> sessions;
+        // all the session files by type and path, owns the sessions
+        QHash<SessionKey, SessionFile> files;
     };
 
+    static bool sessionLessThan(const Session *s1, const Session *s2) {
+        if (s1->type() != s2->type())
+            return s1->type() < s2->type();
+        return QString::compare(QFileInfo(s1->fileName()).fileName(), QFileInfo(s2->fileName()).fileName(), Qt::CaseInsensitive) < 0;
+    }
+
+    static bool isExecAllowed(const QString &tryExec) {
+        return tryExec.isEmpty() || ExecutableIndex::contains(tryExec);
+    }
+
+    static bool isVisible(const Session *session) {
+        return !session->isHidden() && !session->isNoDisplay() && isExecAllowed(session->tryExec());
+    }
+
     SessionModel::SessionModel(QObject *parent) : QAbstractListModel(parent), d(new SessionModelPrivate()) {
         // initial population
-        beginResetModel();
-        populate(Session::X11Session, mainConfig.X11.SessionDir.get());
-        populate(Session::WaylandSession, mainConfig.Wayland.SessionDir.get());
-        endResetModel();
+        refresh();
 
         // refresh everytime a file is changed, added or removed
         QFileSystemWatcher *watcher = new QFileSystemWatcher(this);
         connect(watcher, &QFileSystemWatcher::directoryChanged, [this](const QString &path) {
-            beginResetModel();
-            d->sessions.clear();
-            populate(Session::X11Session, mainConfig.X11.SessionDir.get());
-            populate(Session::WaylandSession, mainConfig.Wayland.SessionDir.get());
-            endResetModel();
+            refresh();
         });
         watcher->addPath(mainConfig.X11.SessionDir.get());
         watcher->addPath(mainConfig.Wayland.SessionDir.get());
@@ -79,6 +105,12 @@ namespace SDDM {
         return d->lastIndex;
     }
 
+    Session SessionModel::session(int row) const {
+        if (row < 0 || row >= d->sessions.count())
+            return Session();
+        return *d->sessions.at(row);
+    }
+
     int SessionModel::rowCount(const QModelIndex &parent) const {
         return d->sessions.length();
     }
@@ -112,48 +144,134 @@ namespace SDDM {
         return QVariant();
     }
 
-    void SessionModel::populate(Session::Type type, const QString &path) {
-        // read session files
-        QDir dir(path);
-        dir.setNameFilters(QStringList() << QStringLiteral("*.desktop"));
-        dir.setFilter(QDir::Files);
-        // read session
-        foreach(const QString &session, dir.entryList()) {
-            if (!dir.exists(session))
+    void SessionModel::refresh() {
+        // the daemon's catalog has the sessions parsed already, as long as
+        // it's current, otherwise read the session files
+        SessionCatalog catalog;
+        catalog.open(SessionCatalog::defaultPath());
+
+        auto load = [&catalog](const SessionKey &key) {
+            const Session::Type type = static_cast<Session::Type>(key.first);
+            const int row = catalog.indexOf(type, key.second);
+            return row != -1 ? new Session(catalog.session(row)) : new Session(type, key.second);
+        };
+        auto isListed = [&catalog](const SessionKey &key, const Session *session) {
+            const int row = catalog.indexOf(static_cast<Session::Type>(key.first), key.second);
+            if (row == -1)
+                return isVisible(session);
+            return !(catalog.flags(row) & (SessionCatalog::HiddenFlag | SessionCatalog::NoDisplayFlag)) &&
+                    (catalog.flags(row) & SessionCatalog::ExecAllowedFlag);
+        };
+
+        // session files currently on disk and their modification time
+        QHash<SessionKey, qint64> found;
+        if (catalog.isOpen()) {
+            for (int row = 0; row < catalog.count(); ++row)
+                found.insert(SessionKey(catalog.type(row), catalog.fileName(row)), catalog.modified(row));
+        } else {
+            scan(Session::X11Session, mainConfig.X11.SessionDir.get(), found);
+            scan(Session::WaylandSession, mainConfig.Wayland.SessionDir.get(), found);
+        }
+
+        // files that were removed, changed or whose TryExec changed
+        for (auto it = d->files.begin(); it != d->files.end();) {
+            SessionFile &file = it.value();
+            auto current = found.constFind(it.key());
+
+            if (current == found.constEnd()) {
+                if (file.visible)
+                    removeSession(file.session);
+                delete file.session;
+                it = d->files.erase(it);
                 continue;
+            }
 
-            Session *si = new Session(type, session);
-            bool execAllowed = true;
-            QFileInfo fi(si->tryExec());
-            if (fi.isAbsolute()) {
-                if (!fi.exists() || !fi.isExecutable())
-                    execAllowed = false;
-            } else {
-                execAllowed = false;
-                QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-                QString envPath = env.value(QStringLiteral("PATH"));
-                QStringList pathList = envPath.split(QLatin1Char(':'));
-                foreach(const QString &path, pathList) {
-                    QDir pathDir(path);
-                    fi.setFile(pathDir, si->tryExec());
-                    if (fi.exists() && fi.isExecutable()) {
-                        execAllowed = true;
-                        break;
-                    }
+            if (current.value() != file.modified) {
+                Session *session = load(it.key());
+                const bool visible = isListed(it.key(), session);
+
+                if (file.visible && visible) {
+                    // same position, different content
+                    const int row = d->sessions.indexOf(file.session);
+                    d->sessions[row] = session;
+                    emit dataChanged(index(row), index(row));
+                } else {
+                    if (file.visible)
+                        removeSession(file.session);
+                    if (visible)
+                        insertSession(session);
                 }
+
+                delete file.session;
+                file.session = session;
+                file.modified = current.value();
+                file.visible = visible;
+            } else {
+                // the program in TryExec may have been installed or removed
+                const bool visible = isListed(it.key(), file.session);
+                if (visible && !file.visible)
+                    insertSession(file.session);
+                else if (!visible && file.visible)
+                    removeSession(file.session);
+                file.visible = visible;
             }
-            // add to sessions list
-            if (!si->isHidden() && execAllowed)
-                d->sessions.push_back(si);
-            else
-                delete si;
+
+            ++it;
         }
+
+        // new files
+        for (auto it = found.constBegin(); it != found.constEnd(); ++it) {
+            if (d->files.contains(it.key()))
+                continue;
+
+            SessionFile file;
+            file.session = load(it.key());
+            file.modified = it.value();
+            file.visible = isListed(it.key(), file.session);
+            if (file.visible)
+                insertSession(file.session);
+            d->files.insert(it.key(), file);
+        }
+
         // find out index of the last session
+        int lastIndex = 0;
         for (int i = 0; i < d->sessions.size(); ++i) {
             if (d->sessions.at(i)->fileName() == stateConfig.Last.Session.get()) {
-                d->lastIndex = i;
+                lastIndex = i;
                 break;
             }
         }
+        if (d->lastIndex != lastIndex) {
+            d->lastIndex = lastIndex;
+            emit lastIndexChanged();
+        }
+    }
+
+    void SessionModel::scan(Session::Type type, const QString &path, QHash<QPair<int, QString>, qint64> &found) {
+        // read session files
+        QDir dir(path);
+        dir.setNameFilters(QStringList() << QStringLiteral("*.desktop"));
+        dir.setFilter(QDir::Files);
+        foreach(const QFileInfo &info, dir.entryInfoList())
+            found.insert(SessionKey(type, info.fileName()), info.lastModified().toMSecsSinceEpoch());
+    }
+
+    void SessionModel::insertSession(Session *session) {
+        auto it = std::upper_bound(d->sessions.begin(), d->sessions.end(), session, sessionLessThan);
+        const int row = int(it - d->sessions.begin());
+
+        beginInsertRows(QModelIndex(), row, row);
+        d->sessions.insert(row, session);
+        endInsertRows();
+    }
+
+    void SessionModel::removeSession(Session *session) {
+        const int row = d->sessions.indexOf(session);
+        if (row == -1)
+            return;
+
+        beginRemoveRows(QModelIndex(), row, row);
+        d->sessions.remove(row);
+        endRemoveRows();
     }
 }
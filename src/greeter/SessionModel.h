@@ -26,6 +26,7 @@
 #include <QAbstractListModel>
 
 #include <QHash>
+#include <QPair>
 
 namespace SDDM {
     class SessionModelPrivate;
@@ -33,7 +34,7 @@ namespace SDDM {
     class SessionModel : public QAbstractListModel {
         Q_OBJECT
         Q_DISABLE_COPY(SessionModel)
-        Q_PROPERTY(int lastIndex READ lastIndex CONSTANT)
+        Q_PROPERTY(int lastIndex READ lastIndex NOTIFY lastIndexChanged)
     public:
         enum SessionRole {
             DirectoryRole = Qt::UserRole + 1,
@@ -51,13 +52,22 @@ namespace SDDM {
 
         const int lastIndex() const;
 
+        // Copy of the session at row, no file is read
+        Session session(int row) const;
+
         int rowCount(const QModelIndex &parent = QModelIndex()) const override;
         QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 
+    signals:
+        void lastIndexChanged();
+
     private:
         SessionModelPrivate *d { nullptr };
 
-        void populate(Session::Type type, const QString &path);
+        void refresh();
+        void scan(Session::Type type, const QString &path, QHash<QPair<int, QString>, qint64> &found);
+        void insertSession(Session *session);
+        void removeSession(Session *session);
     };
 }
 
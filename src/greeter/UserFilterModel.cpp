@@ -0,0 +1,216 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#include "UserFilterModel.h"
+
+#include "UserModel.h"
+
+#include <algorithm>
+
+namespace SDDM {
+    struct PrefixKey {
+        // case folded string in the key pool
+        int offset;
+        int length;
+        int row;
+    };
+
+    class UserFilterModelPrivate {
+    public:
+        UserModel *source { nullptr };
+        QString filterString;
+        QString folded;
+
+        // keys sorted by string, names and the words of real names
+        QString pool;
+        QVector<PrefixKey> keys;
+        bool dirty { true };
+
+        // matching source rows, sorted
+        QVector<int> rows;
+
+        QStringRef key(const PrefixKey &key) const {
+            return QStringRef(&pool, key.offset, key.length);
+        }
+    };
+
+    UserFilterModel::UserFilterModel(UserModel *sourceModel, QObject *parent) : QAbstractListModel(parent), d(new UserFilterModelPrivate()) {
+        d->source = sourceModel;
+
+        // without filter rows are the same as the source ones
+        connect(d->source, &QAbstractItemModel::rowsAboutToBeInserted, this, [this](const QModelIndex &, int first, int last) {
+            if (!isFiltered())
+                beginInsertRows(QModelIndex(), first, last);
+        });
+        connect(d->source, &QAbstractItemModel::rowsInserted, this, [this]() {
+            if (!isFiltered())
+                endInsertRows();
+            sourceChanged();
+        });
+        connect(d->source, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &, int first, int last) {
+            if (!isFiltered())
+                beginRemoveRows(QModelIndex(), first, last);
+        });
+        connect(d->source, &QAbstractItemModel::rowsRemoved, this, [this]() {
+            if (!isFiltered())
+                endRemoveRows();
+            sourceChanged();
+        });
+        connect(d->source, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+            if (!isFiltered())
+                beginResetModel();
+        });
+        connect(d->source, &QAbstractItemModel::modelReset, this, [this]() {
+            if (!isFiltered())
+                endResetModel();
+            sourceChanged();
+        });
+        connect(d->source, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles) {
+            // avatars change often and are not indexed
+            const bool indexed = roles.isEmpty() || roles.contains(UserModel::NameRole) || roles.contains(UserModel::RealNameRole);
+            if (indexed)
+                d->dirty = true;
+
+            if (!isFiltered()) {
+                emit dataChanged(index(topLeft.row()), index(bottomRight.row()), roles);
+                return;
+            }
+
+            if (indexed) {
+                applyFilter();
+                return;
+            }
+
+            for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+                auto it = std::lower_bound(d->rows.constBegin(), d->rows.constEnd(), row);
+                if (it != d->rows.constEnd() && *it == row) {
+                    const QModelIndex idx = index(int(it - d->rows.constBegin()));
+                    emit dataChanged(idx, idx, roles);
+                }
+            }
+        });
+    }
+
+    UserFilterModel::~UserFilterModel() {
+        delete d;
+    }
+
+    QHash<int, QByteArray> UserFilterModel::roleNames() const {
+        return d->source->roleNames();
+    }
+
+    QString UserFilterModel::filterString() const {
+        return d->filterString;
+    }
+
+    void UserFilterModel::setFilterString(const QString &filterString) {
+        if (d->filterString == filterString)
+            return;
+
+        d->filterString = filterString;
+        applyFilter();
+
+        emit filterStringChanged();
+    }
+
+    int UserFilterModel::sourceRow(int row) const {
+        if (row < 0 || row >= rowCount())
+            return -1;
+        return isFiltered() ? d->rows.at(row) : row;
+    }
+
+    int UserFilterModel::rowCount(const QModelIndex &parent) const {
+        return isFiltered() ? d->rows.size() : d->source->rowCount();
+    }
+
+    QVariant UserFilterModel::data(const QModelIndex &index, int role) const {
+        const int row = sourceRow(index.row());
+        if (row == -1)
+            return QVariant();
+
+        return d->source->data(d->source->index(row), role);
+    }
+
+    bool UserFilterModel::isFiltered() const {
+        return !d->folded.isEmpty();
+    }
+
+    void UserFilterModel::rebuildIndex() {
+        d->pool.clear();
+        d->keys.clear();
+
+        auto addKey = [this](const QString &str, int row) {
+            const QString folded = str.toCaseFolded();
+            d->keys.append(PrefixKey { d->pool.size(), folded.size(), row });
+            d->pool.append(folded);
+        };
+
+        for (int row = 0; row < d->source->rowCount(); ++row) {
+            const QModelIndex idx = d->source->index(row);
+            addKey(d->source->data(idx, UserModel::NameRole).toString(), row);
+            for (const QString &word : d->source->data(idx, UserModel::RealNameRole).toString().split(QLatin1Char(' '), QString::SkipEmptyParts))
+                addKey(word, row);
+        }
+
+        std::sort(d->keys.begin(), d->keys.end(), [this](const PrefixKey &k1, const PrefixKey &k2) {
+            return d->key(k1) < d->key(k2);
+        });
+
+        d->dirty = false;
+    }
+
+    void UserFilterModel::applyFilter() {
+        const int oldCount = rowCount();
+
+        beginResetModel();
+
+        d->folded = d->filterString.trimmed().toCaseFolded();
+        d->rows.resize(0);
+
+        if (isFiltered()) {
+            if (d->dirty)
+                rebuildIndex();
+
+            // keys starting with the filter are contiguous
+            auto it = std::lower_bound(d->keys.constBegin(), d->keys.constEnd(), d->folded, [this](const PrefixKey &key, const QString &prefix) {
+                return d->key(key) < prefix;
+            });
+            for (; it != d->keys.constEnd() && d->key(*it).startsWith(d->folded); ++it)
+                d->rows.append(it->row);
+
+            // a user can match both by name and real name
+            std::sort(d->rows.begin(), d->rows.end());
+            d->rows.erase(std::unique(d->rows.begin(), d->rows.end()), d->rows.end());
+        }
+
+        endResetModel();
+
+        if (rowCount() != oldCount)
+            emit countChanged();
+    }
+
+    void UserFilterModel::sourceChanged() {
+        d->dirty = true;
+
+        if (isFiltered())
+            applyFilter();
+        else
+            emit countChanged();
+    }
+}
@@ -0,0 +1,68 @@
+/***************************************************************************
+* Copyright (c) 2026 agent <agent@local>
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the
+* Free Software Foundation, Inc.,
+* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+***************************************************************************/
+
+#ifndef SDDM_USERFILTERMODEL_H
+#define SDDM_USERFILTERMODEL_H
+
+#include <QAbstractListModel>
+
+#include <QHash>
+
+namespace SDDM {
+    class UserModel;
+    class UserFilterModelPrivate;
+
+    // Users of a UserModel whose name, or one of the words of whose real
+    // name, starts with filterString. Matches are looked up in a sorted
+    // index of case folded prefixes, an empty filter shows all users.
+    class UserFilterModel : public QAbstractListModel {
+        Q_OBJECT
+        Q_DISABLE_COPY(UserFilterModel)
+        Q_PROPERTY(QString filterString READ filterString WRITE setFilterString NOTIFY filterStringChanged)
+        Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    public:
+        UserFilterModel(UserModel *sourceModel, QObject *parent = 0);
+        ~UserFilterModel();
+
+        QHash<int, QByteArray> roleNames() const override;
+
+        QString filterString() const;
+        void setFilterString(const QString &filterString);
+
+        // Row of the user in userModel
+        Q_INVOKABLE int sourceRow(int row) const;
+
+        int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+        QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    signals:
+        void filterStringChanged();
+        void countChanged();
+
+    private:
+        UserFilterModelPrivate *d { nullptr };
+
+        bool isFiltered() const;
+        void rebuildIndex();
+        void applyFilter();
+        void sourceChanged();
+    };
+}
+
+#endif // SDDM_USERFILTERMODEL_H
@@ -21,115 +21,562 @@
 
 #include "Constants.h"
 #include "Configuration.h"
-
+#include "FaceImageProvider.h"
+#include "StatCache.h"
+#include "UserDatabase.h"
+#include "UserSnapshot.h"
+#include "UserStore.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
 #include <QFile>
-#include <QList>
-#include <QTextStream>
-#include <QStringList>
+#include <QFileSystemWatcher>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QUrl>
+
+#include <algorithm>
+#include <functional>
 
-#include <memory>
-#include <pwd.h>
+Q_DECLARE_METATYPE(SDDM::UserRecord)
+Q_DECLARE_METATYPE(SDDM::UserStore)
 
 namespace SDDM {
-    class User {
+    // hand users over to the model once this many have been collected...
+    static const int s_batchSize = 64;
+    // ...or once this many milliseconds have passed since the last batch
+    static const int s_batchInterval = 100;
+    // threads used to look avatars up
+    static const int s_iconThreads = 4;
+    // wait for this many milliseconds after a change before refreshing
+    static const int s_refreshDelay = 1000;
+    // NSS sources can't be watched, revalidate them every few minutes
+    static const int s_revalidateInterval = 5 * 60 * 1000;
+
+    static UserRecord snapshotRecord(const UserSnapshot &snapshot, int row) {
+        UserRecord user;
+        user.name = snapshot.name(row);
+        user.realName = snapshot.realName(row);
+        user.homeDir = snapshot.homeDir(row);
+        user.icon = snapshot.icon(row);
+        user.needsPassword = snapshot.needsPassword(row);
+        user.uid = snapshot.uid(row);
+        user.gid = snapshot.gid(row);
+        return user;
+    }
+
+    class UserEnumerator : public QObject {
+        Q_OBJECT
     public:
-        QString name;
-        QString realName;
-        QString homeDir;
-        QString icon;
-        bool needsPassword { false };
-        int uid { 0 };
-        int gid { 0 };
+        QString defaultFace;
+    public slots:
+        void enumerate();
+        void collect();
+    signals:
+        void usersFound(const SDDM::UserList &users);
+        void finished();
+        void usersCollected(const SDDM::UserStore &users);
     };
 
-    typedef std::shared_ptr<User> UserPtr;
+    // Looks up the avatar of a single user on the icon thread pool
+    class IconResolver : public QRunnable {
+    public:
+        IconResolver(UserModel *model, int uid, const QString &name, const QString &homeDir, const QString &facesDir)
+            : m_model(model), m_uid(uid), m_name(name), m_homeDir(homeDir), m_facesDir(facesDir) {
+        }
+
+        void run() override {
+            QString icon = UserDatabase::findFace(m_name, m_homeDir, m_facesDir);
+            QString path;
+
+            // serve the face through the image provider, which decodes
+            // and scales it once for all the views
+            if (!icon.isEmpty()) {
+                path = icon.startsWith(QLatin1String("file://")) ? QUrl(icon).toLocalFile() : icon;
+                icon = FaceImageProvider::setFace(m_name, path);
+            }
+
+            // the model waits for the pool before going away
+            QMetaObject::invokeMethod(m_model, "iconResolved", Qt::QueuedConnection,
+                                      Q_ARG(int, m_uid), Q_ARG(QString, icon), Q_ARG(QString, path));
+        }
+
+    private:
+        UserModel *m_model { nullptr };
+        int m_uid { 0 };
+        QString m_name;
+        QString m_homeDir;
+        QString m_facesDir;
+    };
 
     class UserModelPrivate {
     public:
         int lastIndex { 0 };
-        QList<UserPtr> users;
+        bool populated { false };
+        UserStore users;
+        // rows of users sorted by name, one per model row
+        QVector<int> order;
+        // when valid the daemon's snapshot backs the model instead of users
+        UserSnapshot snapshot;
+        // rows of the snapshot by uid, built the first time it's needed
+        QHash<int, int> snapshotRows;
+        QThread *thread { nullptr };
+        UserEnumerator *enumerator { nullptr };
+
+        bool avatars { false };
+        // avatars looked up so far by uid, empty when the user has none
+        QHash<int, QString> icons;
+        // uid of the user each watched avatar belongs to
+        QHash<QString, int> faces;
+        // few threads, avatar lookups are bound by I/O
+        QThreadPool iconPool;
+
+        QFileSystemWatcher *watcher { nullptr };
+        QTimer *refreshTimer { nullptr };
+        QTimer *revalidateTimer { nullptr };
+        bool refreshing { false };
+        bool refreshPending { false };
     };
 
+    void UserEnumerator::enumerate() {
+        // users not yet handed over to the model
+        UserList batch;
+        batch.reserve(s_batchSize);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        UserDatabase::enumerate([&](const UserRecord &record) {
+            // the model is going away, stop early
+            if (QThread::currentThread()->isInterruptionRequested())
+                return false;
+
+            UserRecord user { record };
+            // default face until the real one is looked up
+            user.icon = defaultFace;
+
+            batch << user;
+
+            // stream users to the model while NSS is still busy
+            if (batch.size() >= s_batchSize || timer.elapsed() >= s_batchInterval) {
+                emit usersFound(batch);
+                batch.clear();
+                timer.restart();
+            }
+
+            return true;
+        });
+
+        if (!batch.isEmpty())
+            emit usersFound(batch);
+
+        emit finished();
+    }
+
+    void UserEnumerator::collect() {
+        UserStore users;
+
+        // prefer the daemon's snapshot, it's refreshed on changes too
+        UserSnapshot snapshot;
+        if (snapshot.open(UserSnapshot::defaultPath())) {
+            users.reserve(snapshot.count());
+            for (int row = 0; row < snapshot.count(); ++row)
+                users.append(snapshotRecord(snapshot, row));
+        } else {
+            UserDatabase::enumerate([&](const UserRecord &record) {
+                if (QThread::currentThread()->isInterruptionRequested())
+                    return false;
+
+                UserRecord user { record };
+                user.icon = defaultFace;
+                users.append(user);
+                return true;
+            });
+        }
+
+        if (QThread::currentThread()->isInterruptionRequested())
+            return;
+
+        users.sortByName();
+        emit usersCollected(users);
+    }
+
     UserModel::UserModel(QObject *parent) : QAbstractListModel(parent), d(new UserModelPrivate()) {
-        const QString facesDir = mainConfig.Theme.FacesDir.get();
-        const QString defaultFace = QStringLiteral("file://%1/.face.icon").arg(facesDir);
+        qRegisterMetaType<SDDM::UserList>("SDDM::UserList");
+        qRegisterMetaType<SDDM::UserStore>("SDDM::UserStore");
+
+        d->iconPool.setMaxThreadCount(s_iconThreads);
+
+        // keep track of changes to the user database and to the avatars
+        d->watcher = new QFileSystemWatcher(UserSnapshot::sourceFiles(), this);
+        if (QFile::exists(UserSnapshot::defaultPath()))
+            d->watcher->addPath(UserSnapshot::defaultPath());
+        connect(d->watcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &path) {
+            fileChanged(path);
+        });
+
+        d->refreshTimer = new QTimer(this);
+        d->refreshTimer->setSingleShot(true);
+        d->refreshTimer->setInterval(s_refreshDelay);
+        connect(d->refreshTimer, &QTimer::timeout, this, [this]() {
+            refresh();
+        });
+
+        d->revalidateTimer = new QTimer(this);
+        d->revalidateTimer->setInterval(s_revalidateInterval);
+        connect(d->revalidateTimer, &QTimer::timeout, this, [this]() {
+            refresh();
+        });
+        d->revalidateTimer->start();
+
+        // the daemon keeps a snapshot of the user list, no need to
+        // enumerate anything if it's still valid
+        if (d->snapshot.open(UserSnapshot::defaultPath())) {
+            qDebug() << "Loaded" << d->snapshot.count() << "users from" << UserSnapshot::defaultPath();
+            d->populated = true;
+            d->lastIndex = qMax(0, d->snapshot.indexOf(stateConfig.Last.User.get()));
+            d->avatars = UserDatabase::avatarsEnabled(d->snapshot.count());
+            return;
+        }
 
-        struct passwd *current_pw;
-        while ((current_pw = getpwent()) != nullptr) {
+        // DisableAvatarsThreshold may turn avatars off once all users are known
+        d->avatars = UserDatabase::avatarsEnabled(0);
 
-            // skip entries with uids smaller than minimum uid
-            if (int(current_pw->pw_uid) < mainConfig.Users.MinimumUid.get())
-                continue;
+        // getpwent() can take a long time with network backed
+        // databases, enumerate on a worker thread and stream the
+        // results to the model so that the greeter shows up immediately
+        startEnumerator();
+        QMetaObject::invokeMethod(d->enumerator, "enumerate", Qt::QueuedConnection);
+    }
 
-            // skip entries with uids greater than maximum uid
-            if (int(current_pw->pw_uid) > mainConfig.Users.MaximumUid.get())
-                continue;
-            // skip entries with user names in the hide users list
-            if (mainConfig.Users.HideUsers.get().contains(QString::fromLocal8Bit(current_pw->pw_name)))
-                continue;
+    UserModel::~UserModel() {
+        // the enumerator checks for interruption between entries, a
+        // single NSS call in progress still has to complete though
+        if (d->thread) {
+            d->thread->requestInterruption();
+            d->thread->quit();
+            d->thread->wait();
+        }
 
-            // skip entries with shells in the hide shells list
-            if (mainConfig.Users.HideShells.get().contains(QString::fromLocal8Bit(current_pw->pw_shell)))
-                continue;
+        // pending lookups would call back into the model
+        d->iconPool.clear();
+        d->iconPool.waitForDone();
+
+        delete d;
+    }
+
+    void UserModel::startEnumerator() {
+        if (d->thread)
+            return;
 
-            // skip duplicates
-            // Note: getpwent() makes no attempt to suppress duplicate information
-            // if multiple sources are specified in nsswitch.conf(5).
-            if (d->users.cend()
-                != std::find_if(d->users.cbegin(), d->users.cend(), [current_pw](const UserPtr & u) { return u->uid == current_pw->pw_uid; }))
+        d->enumerator = new UserEnumerator();
+        d->enumerator->defaultFace = UserDatabase::defaultFace();
+
+        d->thread = new QThread(this);
+        d->enumerator->moveToThread(d->thread);
+
+        connect(d->thread, &QThread::finished, d->enumerator, &QObject::deleteLater);
+        connect(d->enumerator, &UserEnumerator::usersFound, this, [this](const UserList &users) {
+            addUsers(users);
+        });
+        connect(d->enumerator, &UserEnumerator::finished, this, [this]() {
+            enumerationFinished();
+        });
+        connect(d->enumerator, &UserEnumerator::usersCollected, this, [this](const UserStore &users) {
+            applyUsers(users);
+        });
+
+        d->thread->start();
+    }
+
+    void UserModel::addUsers(const UserList &users) {
+        QVector<int> added;
+        added.reserve(users.size());
+        for (const UserRecord &user : users) {
+            const int stored = d->users.append(user);
+            if (stored != -1)
+                added << stored;
+        }
+        if (added.isEmpty())
+            return;
+
+        // keep users sorted by username, users sharing a name stay in the
+        // order they were found
+        auto nameLessThan = [this](int row1, int row2) { return d->users.nameLessThan(row1, row2); };
+        std::stable_sort(added.begin(), added.end(), nameLessThan);
+
+        if (d->order.isEmpty()) {
+            // the first batch, the views have nothing to keep
+            beginResetModel();
+            d->order = added;
+            endResetModel();
+        } else {
+            // merged in a single walk over both, the users that end up
+            // next to each other are inserted as one range
+            auto next = added.constBegin();
+            int row = 0;
+            while (next != added.constEnd()) {
+                auto position = std::upper_bound(d->order.constBegin() + row, d->order.constEnd(), *next, nameLessThan);
+                row = int(position - d->order.constBegin());
+                // everything sorting before the user already at that row
+                auto end = position == d->order.constEnd() ? added.constEnd() :
+                        std::lower_bound(next, added.constEnd(), *position, nameLessThan);
+                const int count = int(end - next);
+
+                beginInsertRows(QModelIndex(), row, row + count - 1);
+                d->order.insert(row, count, 0);
+                std::copy(next, end, d->order.begin() + row);
+                endInsertRows();
+
+                row += count;
+                next = end;
+            }
+        }
+
+        emit countChanged();
+
+        updateLastIndex();
+    }
+
+    void UserModel::applyUsers(const UserStore &users) {
+        d->refreshing = false;
+
+        // from now on the store backs the model, the rows stay the same
+        if (d->snapshot.isOpen()) {
+            d->users.clear();
+            d->users.reserve(d->snapshot.count());
+            d->order.clear();
+            d->order.reserve(d->snapshot.count());
+            for (int row = 0; row < d->snapshot.count(); ++row)
+                d->order << d->users.append(snapshotRecord(d->snapshot, row));
+            d->snapshot.close();
+            d->snapshotRows.clear();
+        }
+
+        const int oldCount = d->order.size();
+
+        // remove users that are gone or were renamed
+        for (int row = d->order.size() - 1; row >= 0; --row) {
+            const int stored = d->order.at(row);
+            const int updated = users.indexOfUid(d->users.uid(stored));
+            if (updated != -1 && users.compareName(updated, d->users.name(stored)) == 0)
                 continue;
 
-            // create user
-            UserPtr user { new User() };
-            user->name = QString::fromLocal8Bit(current_pw->pw_name);
-            user->realName = QString::fromLocal8Bit(current_pw->pw_gecos).split(QLatin1Char(',')).first();
-            user->homeDir = QString::fromLocal8Bit(current_pw->pw_dir);
-            user->uid = int(current_pw->pw_uid);
-            user->gid = int(current_pw->pw_gid);
-            // if shadow is used pw_passwd will be 'x' nevertheless, so this
-            // will always be true
-            user->needsPassword = strcmp(current_pw->pw_passwd, "") != 0;
+            beginRemoveRows(QModelIndex(), row, row);
+            d->order.remove(row);
+            endRemoveRows();
+        }
 
-            // search for face icon
-            user->icon = defaultFace;
+        // the remaining rows keep their position, switch them to the new store
+        QVector<int> order;
+        order.reserve(d->order.size());
+        QVector<int> changed;
+        for (int row = 0; row < d->order.size(); ++row) {
+            const int stored = d->order.at(row);
+            const int updated = users.indexOfUid(d->users.uid(stored));
+
+            if (users.homeDir(updated) != d->users.homeDir(stored)) {
+                // look the avatar up again
+                d->icons.remove(d->users.uid(stored));
+                changed << row;
+            } else if (users.realName(updated) != d->users.realName(stored) ||
+                       users.needsPassword(updated) != d->users.needsPassword(stored) ||
+                       users.gid(updated) != d->users.gid(stored)) {
+                changed << row;
+            }
 
-            // add user
-            d->users << user;
+            order << updated;
+        }
+
+        // users sharing a name could end up in a different order,
+        // don't bother with minimal updates then
+        if (std::adjacent_find(order.constBegin(), order.constEnd(), std::greater_equal<int>()) != order.constEnd()) {
+            beginResetModel();
+            d->users = users;
+            d->order.resize(users.count());
+            for (int row = 0; row < users.count(); ++row)
+                d->order[row] = row;
+            endResetModel();
+        } else {
+            d->users = users;
+            d->order = order;
+
+            for (int row : changed)
+                emit dataChanged(index(row), index(row));
+
+            // add new users, rows are sorted like the store
+            int row = 0;
+            for (int stored = 0; stored < d->users.count(); ++stored, ++row) {
+                if (row < d->order.size() && d->order.at(row) == stored)
+                    continue;
+
+                beginInsertRows(QModelIndex(), row, row);
+                d->order.insert(row, stored);
+                endInsertRows();
+            }
         }
 
-        endpwent();
+        if (d->order.size() != oldCount)
+            emit countChanged();
 
-        // sort users by username
-        std::sort(d->users.begin(), d->users.end(), [&](const UserPtr &u1, const UserPtr &u2) { return u1->name < u2->name; });
+        updateLastIndex();
+        updateAvatars();
 
-        bool avatarsEnabled = mainConfig.Theme.EnableAvatars.get();
-        if (avatarsEnabled && mainConfig.Theme.EnableAvatars.isDefault()) {
-            if (d->users.count() > mainConfig.Theme.DisableAvatarsThreshold.get()) avatarsEnabled=false;
+        if (d->refreshPending) {
+            d->refreshPending = false;
+            refresh();
         }
+    }
 
-        // find out index of the last user
-        for (int i = 0; i < d->users.size(); ++i) {
-            UserPtr user { d->users.at(i) };
-            if (user->name == stateConfig.Last.User.get())
-                d->lastIndex = i;
-
-            if (avatarsEnabled) {
-                const QString userFace = QStringLiteral("%1/.face.icon").arg(user->homeDir);
-                const QString systemFace = QStringLiteral("%1/%2.face.icon").arg(facesDir).arg(user->name);
-                QString accountsServiceFace = QStringLiteral("/var/lib/AccountsService/icons/%1").arg(user->name);
-
-                if (QFile::exists(userFace))
-                    user->icon = QStringLiteral("file://%1").arg(userFace);
-                else if (QFile::exists(accountsServiceFace))
-                    user->icon = accountsServiceFace;
-                else if (QFile::exists(systemFace))
-                    user->icon = QStringLiteral("file://%1").arg(systemFace);
+    void UserModel::refresh() {
+        // one enumeration at a time
+        if (d->refreshing || !d->populated) {
+            d->refreshPending = true;
+            return;
+        }
+
+        d->refreshing = true;
+        startEnumerator();
+        QMetaObject::invokeMethod(d->enumerator, "collect", Qt::QueuedConnection);
+    }
+
+    void UserModel::fileChanged(const QString &path) {
+        // files like /etc/passwd are replaced rather than modified,
+        // watch the new inode
+        d->watcher->removePath(path);
+        if (QFile::exists(path))
+            d->watcher->addPath(path);
+
+        auto it = d->faces.find(path);
+        if (it == d->faces.end()) {
+            d->refreshTimer->start();
+            return;
+        }
+
+        // look the avatar up again next time it's shown
+        const int uid = it.value();
+        d->faces.erase(it);
+        d->icons.remove(uid);
+        StatCache::invalidate(path);
+
+        const int row = rowOfUid(uid);
+        if (row != -1)
+            emit dataChanged(index(row), index(row), QVector<int>() << IconRole);
+    }
+
+    int UserModel::rowOfUid(int uid) const {
+        if (d->snapshot.isOpen()) {
+            // the snapshot doesn't change while it's open
+            if (d->snapshotRows.isEmpty()) {
+                d->snapshotRows.reserve(d->snapshot.count());
+                for (int row = 0; row < d->snapshot.count(); ++row)
+                    d->snapshotRows.insert(d->snapshot.uid(row), row);
             }
+            return d->snapshotRows.value(uid, -1);
+        }
+
+        const int stored = d->users.indexOfUid(uid);
+        if (stored == -1)
+            return -1;
+
+        // rows are sorted by name, only users sharing it have to be compared
+        auto it = std::lower_bound(d->order.constBegin(), d->order.constEnd(), stored, [this](int row1, int row2) { return d->users.nameLessThan(row1, row2); });
+        for (; it != d->order.constEnd() && !d->users.nameLessThan(stored, *it); ++it) {
+            if (*it == stored)
+                return int(it - d->order.constBegin());
         }
+        return -1;
     }
 
-    UserModel::~UserModel() {
-        delete d;
+    QString UserModel::icon(int row) const {
+        int uid;
+        QString name, homeDir, icon;
+        if (d->snapshot.isOpen()) {
+            uid = d->snapshot.uid(row);
+            icon = d->snapshot.icon(row);
+        } else {
+            const int stored = d->order.at(row);
+            uid = d->users.uid(stored);
+            icon = d->users.icon(stored);
+        }
+
+        if (!d->avatars)
+            return icon;
+
+        auto it = d->icons.constFind(uid);
+        if (it != d->icons.constEnd())
+            return it.value().isEmpty() ? icon : it.value();
+
+        // look the avatar up in the background, only once
+        d->icons.insert(uid, QString());
+        if (d->snapshot.isOpen()) {
+            name = d->snapshot.name(row);
+            homeDir = d->snapshot.homeDir(row);
+        } else {
+            name = d->users.name(d->order.at(row));
+            homeDir = d->users.homeDir(d->order.at(row));
+        }
+        // the configuration is only read on this thread
+        d->iconPool.start(new IconResolver(const_cast<UserModel *>(this), uid, name, homeDir,
+                                           mainConfig.Theme.FacesDir.get()));
+
+        return icon;
+    }
+
+    void UserModel::iconResolved(int uid, const QString &icon, const QString &path) {
+        if (icon.isEmpty())
+            return;
+
+        d->icons.insert(uid, icon);
+
+        // notice when the avatar is changed
+        if (!path.isEmpty() && !d->faces.contains(path)) {
+            d->faces.insert(path, uid);
+            d->watcher->addPath(path);
+        }
+
+        const int row = rowOfUid(uid);
+        if (row != -1)
+            emit dataChanged(index(row), index(row), QVector<int>() << IconRole);
+    }
+
+    void UserModel::enumerationFinished() {
+        d->populated = true;
+        emit populatedChanged();
+
+        updateAvatars();
+
+        if (d->refreshPending) {
+            d->refreshPending = false;
+            refresh();
+        }
+    }
+
+    void UserModel::updateAvatars() {
+        const bool avatars = UserDatabase::avatarsEnabled(rowCount());
+        if (avatars == d->avatars)
+            return;
+
+        d->avatars = avatars;
+        if (rowCount() > 0)
+            emit dataChanged(index(0), index(rowCount() - 1), QVector<int>() << IconRole);
+    }
+
+    void UserModel::updateLastIndex() {
+        const QString lastUser = stateConfig.Last.User.get();
+
+        // find out index of the last user
+        auto it = std::lower_bound(d->order.constBegin(), d->order.constEnd(), lastUser, [this](int row, const QString &name) { return d->users.compareName(row, name) < 0; });
+        int lastIndex = 0;
+        if (it != d->order.constEnd() && d->users.compareName(*it, lastUser) == 0)
+            lastIndex = int(it - d->order.constBegin());
+
+        if (d->lastIndex != lastIndex) {
+            d->lastIndex = lastIndex;
+            emit lastIndexChanged();
+        }
     }
 
     QHash<int, QByteArray> UserModel::roleNames() const {
@@ -153,33 +600,57 @@ namespace SDDM {
     }
 
     int UserModel::rowCount(const QModelIndex &parent) const {
-        return d->users.length();
+        if (d->snapshot.isOpen())
+            return d->snapshot.count();
+        return d->order.size();
     }
 
     QVariant UserModel::data(const QModelIndex &index, int role) const {
-        if (index.row() < 0 || index.row() > d->users.count())
+        if (index.row() < 0 || index.row() >= rowCount())
             return QVariant();
 
+        if (d->snapshot.isOpen()) {
+            const int row = index.row();
+            if (role == NameRole)
+                return d->snapshot.name(row);
+            else if (role == RealNameRole)
+                return d->snapshot.realName(row);
+            else if (role == HomeDirRole)
+                return d->snapshot.homeDir(row);
+            else if (role == IconRole)
+                return icon(row);
+            else if (role == NeedsPasswordRole)
+                return d->snapshot.needsPassword(row);
+
+            return QVariant();
+        }
+
         // get user
-        UserPtr user = d->users[index.row()];
+        const int row = d->order.at(index.row());
 
         // return correct value
         if (role == NameRole)
-            return user->name;
+            return d->users.name(row);
         else if (role == RealNameRole)
-            return user->realName;
+            return d->users.realName(row);
         else if (role == HomeDirRole)
-            return user->homeDir;
+            return d->users.homeDir(row);
         else if (role == IconRole)
-            return user->icon;
+            return icon(index.row());
         else if (role == NeedsPasswordRole)
-            return user->needsPassword;
+            return d->users.needsPassword(row);
 
         // return empty value
         return QVariant();
     }
 
+    bool UserModel::isPopulated() const {
+        return d->populated;
+    }
+
     int UserModel::disableAvatarsThreshold() const {
         return mainConfig.Theme.DisableAvatarsThreshold.get();
     }
 }
+
+#include "UserModel.moc"
@@ -23,16 +23,22 @@
 #include <QAbstractListModel>
 
 #include <QHash>
+#include <QVector>
 
 namespace SDDM {
+    class UserRecord;
+    class UserStore;
     class UserModelPrivate;
 
+    typedef QVector<UserRecord> UserList;
+
     class UserModel : public QAbstractListModel {
         Q_OBJECT
         Q_DISABLE_COPY(UserModel)
-        Q_PROPERTY(int lastIndex READ lastIndex CONSTANT)
+        Q_PROPERTY(int lastIndex READ lastIndex NOTIFY lastIndexChanged)
         Q_PROPERTY(QString lastUser READ lastUser CONSTANT)
-        Q_PROPERTY(int count READ rowCount CONSTANT)
+        Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+        Q_PROPERTY(bool populated READ isPopulated NOTIFY populatedChanged)
         Q_PROPERTY(int disableAvatarsThreshold READ disableAvatarsThreshold CONSTANT)
     public:
         enum UserRoles {
@@ -54,9 +60,35 @@ namespace SDDM {
         int rowCount(const QModelIndex &parent = QModelIndex()) const override;
         QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 
+        bool isPopulated() const;
+
         int disableAvatarsThreshold() const;
+
+    signals:
+        void lastIndexChanged();
+        void countChanged();
+        // emitted once the whole user database has been enumerated
+        void populatedChanged();
+
+    public slots:
+        // enumerates users again and applies the differences
+        void refresh();
+
+    private slots:
+        void iconResolved(int uid, const QString &icon, const QString &path);
+
     private:
         UserModelPrivate *d { nullptr };
+
+        int rowOfUid(int uid) const;
+        QString icon(int row) const;
+        void startEnumerator();
+        void addUsers(const UserList &users);
+        void applyUsers(const UserStore &users);
+        void fileChanged(const QString &path);
+        void enumerationFinished();
+        void updateAvatars();
+        void updateLastIndex();
     };
 }
 
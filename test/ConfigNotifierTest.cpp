@@ -0,0 +1,131 @@
+/*
+ * Configuration notifier tests
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ConfigNotifierTest.h"
+
+#include "ConfigNotifier.h"
+#include "SignalHandler.h"
+
+#include <QtTest/QtTest>
+
+#include <signal.h>
+
+using namespace SDDM;
+
+QTEST_MAIN(ConfigNotifierTest);
+
+void ConfigNotifierTest::initTestCase() {
+    // the daemon's handlers, SIGHUP goes through the event loop
+    SignalHandler::initialize();
+}
+
+void ConfigNotifierTest::init() {
+    QFile::remove(NOTIFIER_CONF_FILE);
+    QDir(NOTIFIER_CONF_DIR).removeRecursively();
+    QDir().mkdir(NOTIFIER_CONF_DIR);
+}
+
+void ConfigNotifierTest::cleanup() {
+    QFile::remove(NOTIFIER_CONF_FILE);
+    QDir(NOTIFIER_CONF_DIR).removeRecursively();
+}
+
+void ConfigNotifierTest::writeConfig(const QByteArray &contents) {
+    QFile file(NOTIFIER_CONF_FILE);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(contents);
+}
+
+void ConfigNotifierTest::ReloadOnSighup() {
+    writeConfig("String=a\n");
+
+    NotifierTestConfig config;
+    QCOMPARE(config.String.get(), QStringLiteral("a"));
+
+    SignalHandler handler;
+    ConfigNotifier notifier(&config);
+    connect(&handler, &SignalHandler::sighupReceived, &notifier, &ConfigNotifier::reload);
+    QSignalSpy aboutToReload(&notifier, SIGNAL(aboutToReload()));
+    QSignalSpy entryChanged(&notifier, SIGNAL(entryChanged(QString,QString)));
+    QSignalSpy changed(&notifier, SIGNAL(changed()));
+
+    writeConfig("String=b\n"
+                "[Section]\n"
+                "Boolean=false\n");
+    QVERIFY(::raise(SIGHUP) == 0);
+
+    QTRY_COMPARE(entryChanged.count(), 2);
+    QVERIFY(aboutToReload.count() >= 1);
+    QVERIFY(changed.count() >= 1);
+    QCOMPARE(config.String.get(), QStringLiteral("b"));
+    QCOMPARE(config.Section.Boolean.get(), false);
+    QCOMPARE(config.Int.get(), 1);
+
+    QList<QPair<QString, QString>> entries;
+    for (const QList<QVariant> &arguments : entryChanged)
+        entries << qMakePair(arguments.at(0).toString(), arguments.at(1).toString());
+    QVERIFY(entries.contains(qMakePair(QStringLiteral(IMPLICIT_SECTION), QStringLiteral("String"))));
+    QVERIFY(entries.contains(qMakePair(QStringLiteral("Section"), QStringLiteral("Boolean"))));
+
+    // an entry that is removed gets its default back
+    writeConfig("[Section]\n"
+                "Boolean=false\n");
+    QVERIFY(::raise(SIGHUP) == 0);
+    QTRY_COMPARE(entryChanged.count(), 3);
+    QCOMPARE(config.String.get(), QStringLiteral("initial"));
+}
+
+void ConfigNotifierTest::UnchangedOnSighup() {
+    writeConfig("Int=5\n");
+
+    NotifierTestConfig config;
+    SignalHandler handler;
+    ConfigNotifier notifier(&config);
+    connect(&handler, &SignalHandler::sighupReceived, &notifier, &ConfigNotifier::reload);
+    QSignalSpy aboutToReload(&notifier, SIGNAL(aboutToReload()));
+    QSignalSpy entryChanged(&notifier, SIGNAL(entryChanged(QString,QString)));
+
+    QVERIFY(::raise(SIGHUP) == 0);
+    QTRY_COMPARE(aboutToReload.count(), 1);
+    QCOMPARE(entryChanged.count(), 0);
+    QCOMPARE(config.Int.get(), 5);
+}
+
+void ConfigNotifierTest::Load() {
+    writeConfig("Int=5\n");
+
+    NotifierTestConfig config;
+    ConfigNotifier notifier(&config);
+    QSignalSpy entryChanged(&notifier, SIGNAL(entryChanged(QString,QString)));
+
+    // nothing changed, nothing is read
+    const int generation = config.generation();
+    notifier.load();
+    QCOMPARE(config.generation(), generation);
+
+    // loading before the notification is dispatched still reports it
+    QTest::qWait(1100);
+    writeConfig("Int=6\n");
+    notifier.load();
+    QCOMPARE(config.Int.get(), 6);
+    QCOMPARE(entryChanged.count(), 1);
+}
+
+#include "moc_ConfigNotifierTest.cpp"
@@ -0,0 +1,55 @@
+/*
+ * Configuration notifier tests
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef CONFIGNOTIFIERTEST_H
+#define CONFIGNOTIFIERTEST_H
+
+#include <QObject>
+
+#include "ConfigReader.h"
+
+#define NOTIFIER_CONF_FILE QStringLiteral("notifier.conf")
+#define NOTIFIER_CONF_DIR QStringLiteral("notifierconfdir")
+
+Config (NotifierTestConfig, NOTIFIER_CONF_FILE, NOTIFIER_CONF_DIR, QString(),
+    Entry(    String,         QString,         _S("initial"), _S("Test String Description"));
+    Entry(       Int,             int,                     1, _S("Test Integer Description"));
+    Section(Section,
+        Entry(   Boolean,            bool,                  true, _S("Test Boolean Description"));
+    );
+);
+
+class ConfigNotifierTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void ReloadOnSighup();
+    void UnchangedOnSighup();
+    void Load();
+
+private:
+    void writeConfig(const QByteArray &contents);
+};
+
+#endif // CONFIGNOTIFIERTEST_H
@@ -0,0 +1,154 @@
+/*
+ * Configuration saver tests
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ConfigSaverTest.h"
+
+#include "ConfigSaver.h"
+
+#include <QtTest/QtTest>
+
+#include <sys/stat.h>
+
+using namespace SDDM;
+
+QTEST_MAIN(ConfigSaverTest);
+
+// writes started and writes that failed, as the saver logs them
+static int s_writes = 0;
+static int s_failures = 0;
+
+static void countingMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &msg) {
+    if (!msg.startsWith(QLatin1String("Saving ")))
+        return;
+    if (type == QtDebugMsg)
+        ++s_writes;
+    else if (type == QtWarningMsg)
+        ++s_failures;
+}
+
+static ino_t inode(const QString &path) {
+    struct stat st;
+    if (stat(QFile::encodeName(path).constData(), &st) != 0)
+        return 0;
+    return st.st_ino;
+}
+
+void ConfigSaverTest::initTestCase() {
+    qInstallMessageHandler(countingMessageHandler);
+}
+
+void ConfigSaverTest::init() {
+    QDir(SAVER_CONF_DIR).removeRecursively();
+    QDir().mkdir(SAVER_CONF_DIR);
+    s_writes = 0;
+    s_failures = 0;
+}
+
+void ConfigSaverTest::cleanup() {
+    QDir(SAVER_CONF_DIR).removeRecursively();
+}
+
+void ConfigSaverTest::writeConfig(const QByteArray &contents) {
+    QFile file(SAVER_CONF_FILE);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(contents);
+}
+
+void ConfigSaverTest::Debounce() {
+    writeConfig("String=a\n");
+
+    SaverTestConfig config;
+    ConfigSaver saver(&config);
+
+    // nothing changed, nothing to write
+    saver.flush();
+    QCOMPARE(s_writes, 0);
+
+    config.String.set(QStringLiteral("b"));
+    saver.save();
+    config.Section.Int.set(2);
+    saver.save();
+    QTest::qWait(100);
+    config.String.set(QStringLiteral("c"));
+    saver.save();
+
+    // requests in a row are written together, later
+    QVERIFY(config.isDirty());
+    QCOMPARE(s_writes, 0);
+    QTRY_VERIFY_WITH_TIMEOUT(!config.isDirty(), 5000);
+    QCOMPARE(s_writes, 1);
+
+    SaverTestConfig reader;
+    QCOMPARE(reader.String.get(), QStringLiteral("c"));
+    QCOMPARE(reader.Section.Int.get(), 2);
+}
+
+void ConfigSaverTest::AtomicReplace() {
+    writeConfig("# a comment\n"
+                "String=a\n"
+                "Unknown=value\n");
+    const ino_t before = inode(SAVER_CONF_FILE);
+    QVERIFY(before != 0);
+
+    SaverTestConfig config;
+    ConfigSaver saver(&config);
+    config.String.set(QStringLiteral("b"));
+    saver.flush();
+    QTRY_VERIFY(!config.isDirty());
+
+    // a new file took the place of the old one, nothing is left behind
+    QVERIFY(inode(SAVER_CONF_FILE) != before);
+    QCOMPARE(QDir(SAVER_CONF_DIR).entryList(QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot),
+             QStringList() << QStringLiteral("saver.conf"));
+
+    QFile file(SAVER_CONF_FILE);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray contents = file.readAll();
+    QVERIFY(contents.contains("# a comment"));
+    QVERIFY(contents.contains("String=b"));
+    QVERIFY(contents.contains("Unknown=value"));
+}
+
+void ConfigSaverTest::Failure() {
+    writeConfig("String=a\n");
+
+    SaverTestConfig config;
+    ConfigSaver saver(&config);
+
+    // a directory in the way, the file can't be replaced
+    QVERIFY(QFile::remove(SAVER_CONF_FILE));
+    QVERIFY(QDir().mkdir(SAVER_CONF_FILE));
+
+    config.String.set(QStringLiteral("b"));
+    saver.flush();
+    QTRY_COMPARE(s_failures, 1);
+    QVERIFY(config.isDirty());
+
+    // the next attempt makes it
+    QVERIFY(QDir().rmdir(SAVER_CONF_FILE));
+    saver.flush();
+    QTRY_VERIFY(!config.isDirty());
+    QCOMPARE(s_writes, 2);
+
+    SaverTestConfig reader;
+    QCOMPARE(reader.String.get(), QStringLiteral("b"));
+}
+
+#include "moc_ConfigSaverTest.cpp"
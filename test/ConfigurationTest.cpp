@@ -25,6 +25,9 @@
 #include <QtCore/QFile>
 #include <QtCore/QDir>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+
 QTEST_MAIN(ConfigurationTest);
 
 void ConfigurationTest::initTestCase() { }
@@ -38,6 +41,7 @@ void ConfigurationTest::init() {
     QDir(SYS_CONF_DIR).removeRecursively();
     QDir().mkdir(SYS_CONF_DIR);
     QFile::remove(CONF_FILE_COPY);
+    QFile::remove(SNAPSHOT_FILE);
     config = new TestConfig;
 }
 
@@ -46,6 +50,7 @@ void ConfigurationTest::cleanup() {
     QDir(CONF_DIR).removeRecursively();
     QDir(SYS_CONF_DIR).removeRecursively();
     QFile::remove(CONF_FILE_COPY);
+    QFile::remove(SNAPSHOT_FILE);
     if (config)
         delete config;
     config = nullptr;
@@ -244,4 +249,189 @@ void ConfigurationTest::FileChanged()
     QVERIFY(config->Int.get() == 222222);
 }
 
+void ConfigurationTest::Unchanged()
+{
+    const int generation = config->generation();
+
+    // nothing was touched, the files aren't read again
+    QVERIFY(!config->load());
+    QVERIFY(config->generation() == generation);
+
+    QTest::qWait(2000);
+
+    QFile confFileA(CONF_DIR+QStringLiteral("/0001A"));
+    confFileA.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFileA.write("Int=333333\n");
+    confFileA.close();
+
+    QVERIFY(config->load());
+    QVERIFY(config->generation() == generation + 1);
+    QVERIFY(config->Int.get() == 333333);
+    QVERIFY(!config->load());
+}
+
+void ConfigurationTest::LargeFile()
+{
+    // 10000 lines of the kind a big configuration is made of, every entry
+    // is set over and over so the last round decides the values
+    QFile confFile(CONF_FILE);
+    confFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    for (int i = 0; i < 1000; ++i) {
+        confFile.write("# Round " + QByteArray::number(i) + "\n");
+        confFile.write("[General]\n");
+        confFile.write("String=General " + QByteArray::number(i) + "\n");
+        confFile.write("Int=" + QByteArray::number(i) + "\n");
+        confFile.write("Custom=bar\n");
+        confFile.write("[Section]\n");
+        confFile.write("StringList=a, b," + QByteArray::number(i) + "\n");
+        confFile.write("Boolean=false  # trailing comment\n");
+        confFile.write("Unknown=value\n");
+        confFile.write("\n");
+    }
+    confFile.close();
+
+    QBENCHMARK {
+        config->reload();
+    }
+
+    QVERIFY(config->String.get() == QStringLiteral("General 999"));
+    QVERIFY(config->Int.get() == 999);
+    QVERIFY(config->Custom.get() == TestConfig::BAR);
+    QVERIFY(config->Section.StringList.get() == QStringList({QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("999")}));
+    QVERIFY(config->Section.Boolean.get() == false);
+    QVERIFY(config->hasUnused());
+}
+
+void ConfigurationTest::Origins()
+{
+    delete config;
+
+    QFile confFileA(CONF_DIR+QStringLiteral("/0001A"));
+    confFileA.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFileA.write("[Section]\n");
+    confFileA.write("Int=1\n");
+    confFileA.close();
+
+    QFile confFileMain(CONF_FILE);
+    confFileMain.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    confFileMain.write("# comment\n");
+    confFileMain.write("String=a\n");
+    confFileMain.close();
+
+    config = new TestConfig;
+    QVERIFY(config->origin(&config->String) == CONF_FILE + QStringLiteral(":2"));
+    QVERIFY(config->Section.origin(&config->Section.Int) == QFileInfo(confFileA).absoluteFilePath() + QStringLiteral(":2"));
+    QVERIFY(config->origin(&config->Int).isEmpty());
+    QVERIFY(config->Section.Int.get() == 1);
+
+    // values set by the program don't come from a file
+    config->String.set(QStringLiteral("b"));
+    QVERIFY(config->origin(&config->String).isEmpty());
+}
+
+// Changes a file but not its modification time, only a snapshot still
+// has the old contents then
+static bool rewriteKeepingTime(const QString &path, const QByteArray &contents) {
+    struct stat st;
+    if (stat(QFile::encodeName(path).constData(), &st) != 0)
+        return false;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    file.write(contents);
+    file.close();
+
+    const struct timespec times[2] = { st.st_atim, st.st_mtim };
+    return utimensat(AT_FDCWD, QFile::encodeName(path).constData(), times, 0) == 0;
+}
+
+static bool makeSnapshot(const QByteArray &contents) {
+    QFile confFile(CONF_FILE);
+    if (!confFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    confFile.write(contents);
+    confFile.close();
+
+    SnapshotTestConfig writer;
+    writer.setWriteSnapshot(true);
+    return writer.writeSnapshot() && QFile::exists(SNAPSHOT_FILE);
+}
+
+void ConfigurationTest::SnapshotUsed()
+{
+    QVERIFY(makeSnapshot("String=a\n[Section]\nBoolean=false\n"));
+    QVERIFY(rewriteKeepingTime(CONF_FILE, "String=b\n"));
+
+    // nothing looks changed, the files aren't read
+    SnapshotTestConfig reader;
+    QCOMPARE(reader.String.get(), QStringLiteral("a"));
+    QCOMPARE(reader.Int.get(), TEST_INT_1);
+    QCOMPARE(reader.Section.Boolean.get(), false);
+    QCOMPARE(reader.origin(&reader.String), CONF_FILE + QStringLiteral(":1"));
+    QCOMPARE(reader.generation(), 1);
+
+    // unless asked to
+    reader.reload();
+    QCOMPARE(reader.String.get(), QStringLiteral("b"));
+}
+
+void ConfigurationTest::SnapshotStale()
+{
+    QVERIFY(makeSnapshot("String=a\n"));
+
+    // modification times are compared to the millisecond
+    QTest::qWait(50);
+    QFile confFile(CONF_FILE);
+    QVERIFY(confFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    confFile.write("String=b\n");
+    confFile.close();
+
+    SnapshotTestConfig reader;
+    QCOMPARE(reader.String.get(), QStringLiteral("b"));
+
+    // a file added to one of the directories
+    QVERIFY(makeSnapshot("String=a\n"));
+    QTest::qWait(50);
+    QFile confFileA(CONF_DIR + QStringLiteral("/0001A"));
+    QVERIFY(confFileA.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    confFileA.write("Int=7\n");
+    confFileA.close();
+
+    SnapshotTestConfig dirReader;
+    QCOMPARE(dirReader.String.get(), QStringLiteral("a"));
+    QCOMPARE(dirReader.Int.get(), 7);
+}
+
+void ConfigurationTest::SnapshotCorrupted()
+{
+    QFile snapshot(SNAPSHOT_FILE);
+
+    // truncated
+    QVERIFY(makeSnapshot("String=a\n"));
+    QVERIFY(snapshot.resize(snapshot.size() - 2));
+    QVERIFY(rewriteKeepingTime(CONF_FILE, "String=b\n"));
+
+    SnapshotTestConfig truncated;
+    QCOMPARE(truncated.String.get(), QStringLiteral("b"));
+
+    // overwritten with garbage of the same size
+    QVERIFY(makeSnapshot("String=a\n"));
+    QVERIFY(snapshot.open(QIODevice::ReadWrite));
+    snapshot.write(QByteArray(int(snapshot.size()), 'x'));
+    snapshot.close();
+    QVERIFY(rewriteKeepingTime(CONF_FILE, "String=c\n"));
+
+    SnapshotTestConfig overwritten;
+    QCOMPARE(overwritten.String.get(), QStringLiteral("c"));
+
+    // shorter than the header
+    QVERIFY(snapshot.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    snapshot.write("SDDM");
+    snapshot.close();
+
+    SnapshotTestConfig header;
+    QCOMPARE(header.String.get(), QStringLiteral("c"));
+}
+
 #include "moc_ConfigurationTest.cpp"
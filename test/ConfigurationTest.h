@@ -30,6 +30,7 @@
 #define CONF_DIR QStringLiteral("testconfdir")
 #define SYS_CONF_DIR QStringLiteral("testconfdir2")
 #define CONF_FILE_COPY QStringLiteral("test_copy.conf")
+#define SNAPSHOT_FILE QStringLiteral("test.conf.cache")
 
 #define TEST_STRING_1_PLAIN "Test Variable Initial String"
 #define TEST_STRING_1 QStringLiteral(TEST_STRING_1_PLAIN)
@@ -56,6 +57,16 @@ Config (TestConfig, CONF_FILE, CONF_DIR, SYS_CONF_DIR,
     );
 );
 
+Config (SnapshotTestConfig, CONF_FILE, CONF_DIR, SYS_CONF_DIR,
+    QString snapshotPath() const override { return SNAPSHOT_FILE; }
+
+    Entry(    String,         QString,         _S(TEST_STRING_1_PLAIN), _S("Test String Description"));
+    Entry(       Int,             int,                      TEST_INT_1, _S("Test Integer Description"));
+    Section(Section,
+        Entry(   Boolean,            bool,                     TEST_BOOL_1, _S("Test Boolean Description"));
+    );
+);
+
 inline QTextStream& operator>>(QTextStream &str, TestConfig::CustomType &state) {
     QString text = str.readLine().trimmed();
     if (text.compare(QLatin1String("foo"), Qt::CaseInsensitive) == 0)
@@ -95,6 +106,12 @@ private slots:
     void RightOnInit();
     void RightOnInitDir();
     void FileChanged();
+    void Unchanged();
+    void LargeFile();
+    void Origins();
+    void SnapshotUsed();
+    void SnapshotStale();
+    void SnapshotCorrupted();
 
 private:
     TestConfig *config;
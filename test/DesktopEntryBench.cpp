@@ -0,0 +1,162 @@
+/*
+ * Desktop entry parser benchmark
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "DesktopEntryBench.h"
+
+#include "DesktopEntry.h"
+
+#include <QtTest/QtTest>
+
+using namespace SDDM;
+
+QTEST_MAIN(DesktopEntryBench);
+
+static const char *locales[] = { "de", "fr", "pt_BR", "sr@latin", "zh_CN" };
+
+static QByteArray generateEntry(int i) {
+    QByteArray data;
+    data += "# generated session " + QByteArray::number(i) + "\n";
+    data += "[Desktop Entry]\n";
+    data += "Type=XSession\n";
+    data += "Name=Session " + QByteArray::number(i) + "\n";
+    for (const char *locale : locales)
+        data += QByteArray("Name[") + locale + "]=Session " + locale + " " + QByteArray::number(i) + "\n";
+    data += "Comment=A generated session\\nwith two lines\n";
+    for (const char *locale : locales)
+        data += QByteArray("Comment[") + locale + "]=Generated " + locale + "\n";
+    data += "Exec=/usr/bin/session-" + QByteArray::number(i) + " --with-argument\n";
+    data += "TryExec=/usr/bin/session-" + QByteArray::number(i) + "\n";
+    data += "DesktopNames=Session" + QByteArray::number(i) + ";Generated;\n";
+    data += "Hidden=false\n";
+    data += "\n[Desktop Action New]\nName=Ignored\nExec=/bin/false\n";
+    return data;
+}
+
+void DesktopEntryBench::initTestCase() {
+    QVERIFY(dir.isValid());
+
+    entries.reserve(SYNTHETIC_ENTRIES);
+    for (int i = 0; i < SYNTHETIC_ENTRIES; ++i) {
+        entries << generateEntry(i);
+
+        QFile file(dir.filePath(QStringLiteral("session%1.desktop").arg(i)));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(entries.last()), qint64(entries.last().size()));
+    }
+}
+
+void DesktopEntryBench::Parse() {
+    int valid = 0;
+    QBENCHMARK {
+        valid = 0;
+        for (const QByteArray &data : entries) {
+            DesktopEntry entry;
+            entry.setLocale("pt_BR.UTF-8");
+            if (entry.parse(data) && !entry.localizedValue("Name").isEmpty() && !entry.value("Exec").isEmpty())
+                ++valid;
+        }
+    }
+    QCOMPARE(valid, SYNTHETIC_ENTRIES);
+}
+
+void DesktopEntryBench::Load() {
+    int valid = 0;
+    QBENCHMARK {
+        valid = 0;
+        for (int i = 0; i < SYNTHETIC_ENTRIES; ++i) {
+            DesktopEntry entry;
+            if (entry.load(dir.filePath(QStringLiteral("session%1.desktop").arg(i))) && !entry.value("Exec").isEmpty())
+                ++valid;
+        }
+    }
+    QCOMPARE(valid, SYNTHETIC_ENTRIES);
+}
+
+void DesktopEntryBench::Localized() {
+    DesktopEntry entry;
+    QVERIFY(entry.parse(entries.first()));
+
+    entry.setLocale("pt_BR.UTF-8");
+    QCOMPARE(entry.localizedValue("Name"), QStringLiteral("Session pt_BR 0"));
+    entry.setLocale("de_AT.UTF-8@euro");
+    QCOMPARE(entry.localizedValue("Name"), QStringLiteral("Session de 0"));
+    entry.setLocale("sr_RS@latin");
+    QCOMPARE(entry.localizedValue("Name"), QStringLiteral("Session sr@latin 0"));
+    entry.setLocale("it_IT");
+    QCOMPARE(entry.localizedValue("Name"), QStringLiteral("Session 0"));
+    entry.setLocale(QByteArray());
+    QCOMPARE(entry.localizedValue("Comment"), QStringLiteral("A generated session\nwith two lines"));
+
+    // unlocalized lookups never pick a translation
+    entry.setLocale("de");
+    QCOMPARE(entry.value("Name"), QStringLiteral("Session 0"));
+}
+
+void DesktopEntryBench::Escapes() {
+    DesktopEntry entry;
+    QVERIFY(entry.parse(QByteArrayLiteral(
+        "[Desktop Entry]\n"
+        "Name = \\sSpaced\\tTabbed\\\\\n"
+        "Exec=sh -c 'a\\;b'\r\n"
+        "DesktopNames=A\\;B;C;;D\n"
+        "Hidden=true\n")));
+
+    QCOMPARE(entry.value("Name"), QStringLiteral(" Spaced\tTabbed\\"));
+    QCOMPARE(entry.value("Exec"), QStringLiteral("sh -c 'a\\;b'"));
+    QCOMPARE(entry.listValue("DesktopNames"), QStringList() << QStringLiteral("A;B") << QStringLiteral("C")
+                                                           << QString() << QStringLiteral("D"));
+    QVERIFY(entry.boolValue("Hidden"));
+    QVERIFY(!entry.boolValue("NoDisplay"));
+    QVERIFY(!entry.contains("NoDisplay"));
+}
+
+void DesktopEntryBench::Continuation() {
+    DesktopEntry entry;
+    QVERIFY(entry.parse(QByteArrayLiteral(
+        "[Desktop Entry]\n"
+        "Exec=/usr/bin/session \\\n"
+        "    --first \\\r\n"
+        "    --second\n"
+        "Name=Ends with a backslash\\\\\n"
+        "Comment=Last\\")));
+
+    QCOMPARE(entry.value("Exec"), QStringLiteral("/usr/bin/session --first --second"));
+    QCOMPARE(entry.value("Name"), QStringLiteral("Ends with a backslash\\"));
+    QCOMPARE(entry.value("Comment"), QStringLiteral("Last\\"));
+}
+
+void DesktopEntryBench::Groups() {
+    const QByteArray data = QByteArrayLiteral(
+        "[Desktop Entry]\n"
+        "Name=Entry\n"
+        "[SddmGreeterTheme]\n"
+        "MainScript=Theme.qml\n");
+
+    DesktopEntry theme(QStringLiteral("SddmGreeterTheme"));
+    QVERIFY(theme.parse(data));
+    QCOMPARE(theme.value("MainScript"), QStringLiteral("Theme.qml"));
+    QVERIFY(!theme.contains("Name"));
+
+    DesktopEntry missing(QStringLiteral("Missing"));
+    QVERIFY(!missing.parse(data));
+    QCOMPARE(missing.value("Name", QStringLiteral("default")), QStringLiteral("default"));
+}
+
+#include "moc_DesktopEntryBench.cpp"
@@ -0,0 +1,48 @@
+/*
+ * Desktop entry parser benchmark
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef DESKTOPENTRYBENCH_H
+#define DESKTOPENTRYBENCH_H
+
+#include <QObject>
+#include <QTemporaryDir>
+#include <QVector>
+
+#define SYNTHETIC_ENTRIES 4000
+
+class DesktopEntryBench : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void Parse();
+    void Load();
+    void Localized();
+    void Escapes();
+    void Continuation();
+    void Groups();
+
+private:
+    QTemporaryDir dir;
+    QVector<QByteArray> entries;
+};
+
+#endif // DESKTOPENTRYBENCH_H
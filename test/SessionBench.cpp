@@ -0,0 +1,106 @@
+/*
+ * Session value benchmark
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SessionBench.h"
+
+#include "Configuration.h"
+#include "Session.h"
+
+#include <QtTest/QtTest>
+
+using namespace SDDM;
+
+QTEST_MAIN(SessionBench);
+
+#define SESSION_FILE "bench.desktop"
+
+void SessionBench::initTestCase() {
+    QVERIFY(dir.isValid());
+    mainConfig.X11.SessionDir.set(dir.path());
+
+    QFile file(dir.filePath(QStringLiteral(SESSION_FILE)));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QTextStream out(&file);
+    out << "[Desktop Entry]\n"
+           "Name=Bench\n"
+           "Comment=Benchmark session\n"
+           "Exec=/usr/bin/bench-session\n"
+           "TryExec=/usr/bin/bench-session\n"
+           "DesktopNames=Bench;Test\n";
+}
+
+void SessionBench::Load() {
+    Session session;
+    QBENCHMARK {
+        session.setTo(Session::X11Session, QStringLiteral(SESSION_FILE));
+    }
+    QVERIFY(session.isValid());
+    QCOMPARE(session.displayName(), QStringLiteral("Bench"));
+}
+
+void SessionBench::Copy() {
+    const Session session(Session::X11Session, QStringLiteral(SESSION_FILE));
+    int valid = 0;
+    QBENCHMARK {
+        Session copy(session);
+        valid += copy.isValid();
+    }
+    QVERIFY(valid > 0);
+}
+
+void SessionBench::Assign() {
+    const Session session(Session::X11Session, QStringLiteral(SESSION_FILE));
+    Session copy;
+    QBENCHMARK {
+        copy = session;
+    }
+    QCOMPARE(copy.exec(), session.exec());
+}
+
+void SessionBench::Detach() {
+    const Session session(Session::X11Session, QStringLiteral(SESSION_FILE));
+    Session copy = session;
+    copy.setVt(7);
+    QCOMPARE(copy.vt(), 7);
+    QCOMPARE(session.vt(), 0);
+    QCOMPARE(copy.displayName(), session.displayName());
+}
+
+void SessionBench::SurvivesRemoval() {
+    QTemporaryDir other;
+    QVERIFY(other.isValid());
+    const QString path = other.filePath(QStringLiteral("gone.desktop"));
+    QVERIFY(QFile::copy(dir.filePath(QStringLiteral(SESSION_FILE)), path));
+
+    Session session(Session::X11Session, path);
+    QVERIFY(QFile::remove(path));
+
+    // neither copying nor assigning may go back to the file
+    Session copy(session);
+    Session assigned;
+    assigned = session;
+    QVERIFY(copy.isValid());
+    QVERIFY(assigned.isValid());
+    QCOMPARE(copy.desktopNames(), QStringLiteral("Bench:Test"));
+    QCOMPARE(assigned.exec(), QStringLiteral("/usr/bin/bench-session"));
+    QCOMPARE(assigned.fileName(), path);
+}
+
+#include "moc_SessionBench.cpp"
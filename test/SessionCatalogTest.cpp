@@ -0,0 +1,164 @@
+/*
+ * Session catalog test
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SessionCatalogTest.h"
+
+#include "Configuration.h"
+#include "SessionCatalog.h"
+
+#include <QtTest/QtTest>
+
+using namespace SDDM;
+
+QTEST_MAIN(SessionCatalogTest);
+
+void SessionCatalogTest::init() {
+    QVERIFY(sessions.isValid());
+    QVERIFY(waylandSessions.isValid());
+    QVERIFY(runtime.isValid());
+
+    for (const QString &file : QDir(sessions.path()).entryList(QDir::Files))
+        QFile::remove(sessions.filePath(file));
+    QFile::remove(catalogPath());
+
+    mainConfig.X11.SessionDir.set(sessions.path());
+    mainConfig.Wayland.SessionDir.set(waylandSessions.path());
+    // TryExec is only looked up in a directory of its own
+    mainConfig.Users.DefaultPath.set(runtime.path());
+
+    writeSession(QStringLiteral("plain.desktop"), "plain-session");
+    writeSession(QStringLiteral("missing.desktop"), "missing-session", "TryExec=sddm-test-no-such-program\n");
+    writeSession(QStringLiteral("hidden.desktop"), "hidden-session", "Hidden=true\n");
+}
+
+void SessionCatalogTest::writeSession(const QString &fileName, const QByteArray &exec, const QByteArray &extra) {
+    QFile file(sessions.filePath(fileName));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("[Desktop Entry]\n"
+               "Name=" + fileName.toUtf8() + "\n"
+               "Exec=" + exec + "\n" + extra);
+}
+
+QString SessionCatalogTest::catalogPath() const {
+    return runtime.filePath(QStringLiteral("sessions.cache"));
+}
+
+void SessionCatalogTest::Parse() {
+    QVERIFY(SessionCatalog::write(catalogPath()));
+
+    SessionCatalog catalog;
+    QVERIFY(catalog.open(catalogPath()));
+    QVERIFY(catalog.isCurrent());
+    QCOMPARE(catalog.count(), 3);
+
+    // sorted by file name
+    QCOMPARE(catalog.fileName(0), QStringLiteral("hidden.desktop"));
+    QCOMPARE(catalog.fileName(1), QStringLiteral("missing.desktop"));
+    QCOMPARE(catalog.fileName(2), QStringLiteral("plain.desktop"));
+
+    QVERIFY(catalog.flags(0) & SessionCatalog::HiddenFlag);
+    QVERIFY(!(catalog.flags(1) & SessionCatalog::ExecAllowedFlag));
+    QVERIFY(catalog.flags(2) & SessionCatalog::ExecAllowedFlag);
+
+    const Session session = catalog.session(2);
+    QVERIFY(session.isValid());
+    QCOMPARE(session.exec(), QStringLiteral("plain-session"));
+    QCOMPARE(session.type(), Session::X11Session);
+}
+
+void SessionCatalogTest::IndexOf() {
+    QVERIFY(SessionCatalog::write(catalogPath()));
+
+    SessionCatalog catalog;
+    QVERIFY(catalog.open(catalogPath()));
+    QCOMPARE(catalog.indexOf(Session::X11Session, QStringLiteral("plain")), 2);
+    QCOMPARE(catalog.indexOf(Session::X11Session, QStringLiteral("plain.desktop")), 2);
+    QCOMPARE(catalog.indexOf(Session::X11Session, sessions.filePath(QStringLiteral("plain.desktop"))), 2);
+    QCOMPARE(catalog.indexOf(Session::WaylandSession, QStringLiteral("plain")), -1);
+    QCOMPARE(catalog.indexOf(Session::X11Session, QStringLiteral("other")), -1);
+    QCOMPARE(catalog.indexOf(Session::X11Session, QStringLiteral("/elsewhere/plain.desktop")), -1);
+}
+
+void SessionCatalogTest::FileAdded() {
+    QVERIFY(SessionCatalog::write(catalogPath()));
+
+    SessionCatalog catalog;
+    QVERIFY(catalog.open(catalogPath()));
+
+    // stamped with the precision of the file system clock
+    QTest::qWait(50);
+    writeSession(QStringLiteral("added.desktop"), "added-session");
+
+    QVERIFY(!catalog.isCurrent());
+    catalog.close();
+    QVERIFY(!catalog.open(catalogPath()));
+}
+
+void SessionCatalogTest::FileEditedInPlace() {
+    QVERIFY(SessionCatalog::write(catalogPath()));
+
+    SessionCatalog catalog;
+    QVERIFY(catalog.open(catalogPath()));
+    const int row = catalog.indexOf(Session::X11Session, QStringLiteral("plain"));
+    QVERIFY(catalog.isCurrent(row));
+
+    QTest::qWait(50);
+    writeSession(QStringLiteral("plain.desktop"), "edited-session");
+
+    // the directory didn't change, the file did
+    QVERIFY(catalog.isCurrent());
+    QVERIFY(!catalog.isCurrent(row));
+
+    QVERIFY(SessionCatalog::write(catalogPath()));
+    QVERIFY(catalog.open(catalogPath()));
+    QVERIFY(catalog.isCurrent(row));
+    QCOMPARE(catalog.session(row).exec(), QStringLiteral("edited-session"));
+
+    // removed files aren't current either
+    QVERIFY(QFile::remove(sessions.filePath(QStringLiteral("plain.desktop"))));
+    QVERIFY(!catalog.isCurrent(row));
+}
+
+void SessionCatalogTest::ConfigChanged() {
+    QVERIFY(SessionCatalog::write(catalogPath()));
+
+    mainConfig.Users.DefaultPath.set(QStringLiteral("/usr/bin"));
+    SessionCatalog catalog;
+    QVERIFY(!catalog.open(catalogPath()));
+
+    mainConfig.Users.DefaultPath.set(runtime.path());
+    QVERIFY(catalog.open(catalogPath()));
+}
+
+void SessionCatalogTest::Corrupted() {
+    QVERIFY(SessionCatalog::write(catalogPath()));
+
+    QFile file(catalogPath());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 1));
+    file.close();
+
+    SessionCatalog catalog;
+    QVERIFY(!catalog.open(catalogPath()));
+    QVERIFY(!catalog.isOpen());
+    QCOMPARE(catalog.count(), 0);
+}
+
+#include "moc_SessionCatalogTest.cpp"
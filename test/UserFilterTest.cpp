@@ -0,0 +1,119 @@
+/*
+ * User filter test
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "UserFilterTest.h"
+
+#include "Configuration.h"
+#include "UserFilter.h"
+
+#include <QtTest/QtTest>
+
+#include <pwd.h>
+
+using namespace SDDM;
+
+QTEST_MAIN(UserFilterTest);
+
+static bool accepts(const UserFilter &filter, const char *name, int uid, int gid = 100, const char *shell = "/bin/bash") {
+    struct passwd pw = { };
+    pw.pw_name = const_cast<char *>(name);
+    pw.pw_passwd = const_cast<char *>("x");
+    pw.pw_uid = uid_t(uid);
+    pw.pw_gid = gid_t(gid);
+    pw.pw_gecos = const_cast<char *>("");
+    pw.pw_dir = const_cast<char *>("/home");
+    pw.pw_shell = const_cast<char *>(shell);
+    return filter.accepts(&pw);
+}
+
+void UserFilterTest::init() {
+    // nothing hidden, the filters are compiled when a UserFilter is made
+    mainConfig.Users.MinimumUid.set(1000);
+    mainConfig.Users.MaximumUid.set(60000);
+    mainConfig.Users.HideUsers.set(QStringList());
+    mainConfig.Users.HideShells.set(QStringList());
+    mainConfig.Users.HideGroups.set(QStringList());
+}
+
+void UserFilterTest::UidRange() {
+    const UserFilter filter;
+    QVERIFY(!accepts(filter, "daemon", 999));
+    QVERIFY(accepts(filter, "alice", 1000));
+    QVERIFY(accepts(filter, "bob", 60000));
+    QVERIFY(!accepts(filter, "nobody", 65534));
+}
+
+void UserFilterTest::Literals() {
+    mainConfig.Users.HideUsers.set({ QStringLiteral("alice"), QStringLiteral(" bob ") });
+    const UserFilter filter;
+    QVERIFY(!accepts(filter, "alice", 1000));
+    QVERIFY(!accepts(filter, "bob", 1001));
+    QVERIFY(accepts(filter, "alice2", 1002));
+    QVERIFY(accepts(filter, "carol", 1003));
+}
+
+void UserFilterTest::Globs() {
+    mainConfig.Users.HideUsers.set({ QStringLiteral("test*"), QStringLiteral("user?"), QStringLiteral("[ab]dmin") });
+    const UserFilter filter;
+    QVERIFY(!accepts(filter, "test", 1000));
+    QVERIFY(!accepts(filter, "testuser", 1001));
+    QVERIFY(!accepts(filter, "user1", 1002));
+    QVERIFY(accepts(filter, "user10", 1003));
+    QVERIFY(!accepts(filter, "admin", 1004));
+    QVERIFY(!accepts(filter, "bdmin", 1005));
+    QVERIFY(accepts(filter, "cdmin", 1006));
+    QVERIFY(accepts(filter, "mytest", 1007));
+}
+
+void UserFilterTest::Regexes() {
+    // the invalid expression is ignored, the others still apply
+    mainConfig.Users.HideUsers.set({ QStringLiteral("/^svc-[0-9]+$/"), QStringLiteral("/(/"), QStringLiteral("/guest/") });
+    const UserFilter filter;
+    QVERIFY(!accepts(filter, "svc-1", 1000));
+    QVERIFY(!accepts(filter, "svc-42", 1001));
+    QVERIFY(accepts(filter, "svc-x", 1002));
+    QVERIFY(!accepts(filter, "guest", 1003));
+    QVERIFY(!accepts(filter, "myguest2", 1004));
+    QVERIFY(accepts(filter, "(", 1005));
+    // a lone slash is a literal, not an empty expression
+    mainConfig.Users.HideUsers.set({ QStringLiteral("/") });
+    const UserFilter slash;
+    QVERIFY(accepts(slash, "alice", 1000));
+}
+
+void UserFilterTest::Shells() {
+    mainConfig.Users.HideShells.set({ QStringLiteral("/usr/sbin/nologin"), QStringLiteral("*/false"), QStringLiteral("/^/opt//") });
+    const UserFilter filter;
+    QVERIFY(!accepts(filter, "alice", 1000, 100, "/usr/sbin/nologin"));
+    QVERIFY(!accepts(filter, "bob", 1001, 100, "/bin/false"));
+    QVERIFY(!accepts(filter, "carol", 1002, 100, "/opt/shell"));
+    QVERIFY(accepts(filter, "dave", 1003, 100, "/bin/bash"));
+    QVERIFY(accepts(filter, "erin", 1004, 100, "/usr/opt/shell"));
+}
+
+void UserFilterTest::Groups() {
+    // root always exists with gid 0, unknown groups are skipped
+    mainConfig.Users.HideGroups.set({ QStringLiteral("root"), QStringLiteral("sddm-test-no-such-group") });
+    const UserFilter filter;
+    QVERIFY(!accepts(filter, "alice", 1000, 0));
+    QVERIFY(accepts(filter, "bob", 1001, 100));
+}
+
+#include "moc_UserFilterTest.cpp"
@@ -0,0 +1,114 @@
+/*
+ * User store benchmark
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "UserStoreBench.h"
+
+#include "Configuration.h"
+#include "UserDatabase.h"
+#include "UserStore.h"
+
+#include <QtTest/QtTest>
+
+#include <limits>
+#include <stdio.h>
+
+using namespace SDDM;
+
+QTEST_MAIN(UserStoreBench);
+
+static UserStore loadStore(const QString &path) {
+    UserStore store;
+
+    FILE *file = fopen(qPrintable(path), "r");
+    if (!file)
+        return store;
+
+    UserDatabase::enumerate(file, [&store](const UserRecord &user) {
+        store.append(user);
+        return true;
+    });
+    fclose(file);
+
+    return store;
+}
+
+void UserStoreBench::initTestCase() {
+    // don't let the system configuration filter synthetic users out
+    mainConfig.Users.MinimumUid.set(SYNTHETIC_MIN_UID);
+    mainConfig.Users.MaximumUid.set(std::numeric_limits<int>::max());
+    mainConfig.Users.HideUsers.set(QStringList());
+    mainConfig.Users.HideShells.set(QStringList());
+    mainConfig.Users.HideGroups.set(QStringList());
+
+    QVERIFY(passwd.open());
+    QTextStream out(&passwd);
+    for (int i = 0; i < SYNTHETIC_USERS; ++i) {
+        const int uid = SYNTHETIC_MIN_UID + i;
+        out << QStringLiteral("user%1:x:%2:100:User %1,,,:/home/user%1:/bin/bash\n").arg(i).arg(uid);
+    }
+    // duplicates reported by another NSS source
+    for (int i = 0; i < SYNTHETIC_USERS; i += 100)
+        out << QStringLiteral("user%1:x:%2:100:User %1,,,:/home/user%1:/bin/bash\n").arg(i).arg(SYNTHETIC_MIN_UID + i);
+    out.flush();
+    passwd.close();
+}
+
+void UserStoreBench::Enumerate() {
+    UserStore store;
+    QBENCHMARK {
+        store = loadStore(passwd.fileName());
+    }
+    QCOMPARE(store.count(), SYNTHETIC_USERS);
+}
+
+void UserStoreBench::Memory() {
+    UserStore store = loadStore(passwd.fileName());
+    QCOMPARE(store.count(), SYNTHETIC_USERS);
+    QTest::setBenchmarkResult(store.memoryUsage(), QTest::BytesAllocated);
+}
+
+void UserStoreBench::LookupUid() {
+    UserStore store = loadStore(passwd.fileName());
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (int i = 0; i < SYNTHETIC_USERS; ++i) {
+            if (store.uid(store.indexOfUid(SYNTHETIC_MIN_UID + i)) == SYNTHETIC_MIN_UID + i)
+                ++found;
+        }
+    }
+    QCOMPARE(found, SYNTHETIC_USERS);
+    QCOMPARE(store.indexOfUid(SYNTHETIC_MIN_UID - 1), -1);
+}
+
+void UserStoreBench::Sort() {
+    const UserStore loaded = loadStore(passwd.fileName());
+    UserStore store;
+    QBENCHMARK {
+        store = loaded;
+        store.sortByName();
+    }
+    for (int row = 1; row < store.count(); ++row)
+        QVERIFY(!store.nameLessThan(row, row - 1));
+    QCOMPARE(store.uid(store.indexOfUid(SYNTHETIC_MIN_UID)), SYNTHETIC_MIN_UID);
+    QCOMPARE(store.name(store.indexOfUid(SYNTHETIC_MIN_UID + 42)), QStringLiteral("user42"));
+}
+
+#include "moc_UserStoreBench.cpp"